@@ -0,0 +1,74 @@
+/**
+ * @brief Connection search on the network and on the frozen network
+ *
+ * Queries random connections on the intercity test network with
+ * new_connection() and frozen_new_connection() and prints the mean latency per
+ * query.
+ *
+ * Compile:
+ *  gcc -O2 connection_benchmark.c -o connection_benchmark -losurs-io -losurs-reserve -losurs-network -losurs-optimize -losurs-ds -lxml2
+ *
+ * @file connection_benchmark.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <osurs/io.h>
+#include <osurs/reserve.h>
+#include <stdio.h>
+#include <time.h>
+
+#define QUERIES 200000
+
+// Elapsed time in microseconds.
+static double elapsed_us(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e6 +
+           (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    static Node *orig[QUERIES];
+    static Node *dest[QUERIES];
+    static int time[QUERIES];
+
+    // read network
+    Network *network = new_network();
+    if (!import_network(network, "../tests/input/intercity_network.xml")) {
+        perror("Could not load network");
+        return 1;
+    }
+    FrozenNetwork *frozen = freeze_network(network);
+
+    // draw the queries
+    srand(42);
+    for (int i = 0; i < QUERIES; ++i) {
+        orig[i] = hash_map_get_random(network->nodes);
+        dest[i] = hash_map_get_random(network->nodes);
+        time[i] = rand() % (24 * 60 * 60) + 1;
+    }
+
+    printf("%d queries\n\n", QUERIES);
+    printf("%-16s %14s %12s\n", "search", "latency [us]", "connections");
+    for (int frozen_search = 0; frozen_search < 2; ++frozen_search) {
+        struct timespec start, end;
+        long found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < QUERIES; ++i) {
+            Connection *conn =
+                frozen_search
+                    ? frozen_new_connection(frozen, orig[i], dest[i], time[i])
+                    : new_connection(orig[i], dest[i], time[i]);
+            for (Connection *c = conn; c != NULL; c = c->next) ++found;
+            delete_connection(conn);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%-16s %14.3f %12ld\n", frozen_search ? "frozen" : "network",
+               elapsed_us(&start, &end) / QUERIES, found);
+    }
+
+    // cleanup
+    delete_frozen_network(frozen);
+    delete_network(network);
+
+    return 0;
+}
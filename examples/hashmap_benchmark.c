@@ -0,0 +1,106 @@
+/**
+ * @brief Lookup benchmark of chained and open-addressing hashmaps
+ *
+ * Fills a chained and an open-addressing hashmap with the node and route
+ * identifiers of a network and prints the mean latency of building the map and
+ * of a lookup. The network defaults to the intercity test network, another
+ * network file can be passed as the first argument. Synthetic node identifiers
+ * show the behavior on the size of a national network.
+ *
+ * Compile:
+ *  gcc -O2 hashmap_benchmark.c -o hashmap_benchmark -losurs-io -losurs-reserve -losurs-network -losurs-optimize -losurs-ds -lxml2
+ *
+ * @file hashmap_benchmark.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <osurs/io.h>
+#include <stdio.h>
+#include <time.h>
+
+#define LOOKUPS 2000000
+#define SYNTHETIC_NODES 100000
+
+// Elapsed time in nanoseconds.
+static double elapsed_ns(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e9 +
+           (end->tv_nsec - start->tv_nsec);
+}
+
+// Build both kinds of maps on the identifiers and time them.
+static void benchmark(const char *name, const char *ids[], int count) {
+    static const char *queries[LOOKUPS];
+    for (int i = 0; i < LOOKUPS; ++i) queries[i] = ids[rand() % count];
+
+    for (int open = 0; open < 2; ++open) {
+        struct timespec start, end;
+        HashMap map;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        hash_map_init(&map);
+        hash_map_borrow_keys(&map);
+        if (open) hash_map_open_addressing(&map);
+        for (int i = 0; i < count; ++i)
+            hash_map_put(&map, ids[i], (void *)&ids[i]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double build_ns = elapsed_ns(&start, &end);
+
+        long found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < LOOKUPS; ++i)
+            found += hash_map_get(&map, queries[i]) != NULL;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        printf("%-8s %-8s %8d %12.1f %14.1f %10zu\n", name,
+               open ? "open" : "chained", count, build_ns / count,
+               elapsed_ns(&start, &end) / LOOKUPS, hash_map_memory(&map));
+        if (found != LOOKUPS) printf("missing keys\n");
+        hash_map_free(&map);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *file =
+        argc > 1 ? argv[1] : "../tests/input/intercity_network.xml";
+
+    // read network
+    Network *network = new_network();
+    if (!import_network(network, file)) {
+        perror("Could not load network");
+        return 1;
+    }
+
+    // collect the identifiers of the node and route maps
+    int node_count = (int)network->node_list->size;
+    int route_count = (int)network->route_list->size;
+    const char **node_ids = malloc(sizeof(const char *) * node_count);
+    const char **route_ids = malloc(sizeof(const char *) * route_count);
+    for (int i = 0; i < node_count; ++i)
+        node_ids[i] = network_node_at(network, i)->id;
+    for (int i = 0; i < route_count; ++i)
+        route_ids[i] = network_route_at(network, i)->id;
+
+    srand(42);
+    printf("%d lookups\n\n", LOOKUPS);
+    printf("%-8s %-8s %8s %12s %14s %10s\n", "map", "kind", "keys",
+           "put [ns]", "lookup [ns]", "bytes");
+    benchmark("nodes", node_ids, node_count);
+    benchmark("routes", route_ids, route_count);
+
+    // synthetic identifiers in the format of the MATSim stop facilities
+    char(*synthetic)[16] = malloc(sizeof(char[16]) * SYNTHETIC_NODES);
+    const char **synthetic_ids =
+        malloc(sizeof(const char *) * SYNTHETIC_NODES);
+    for (int i = 0; i < SYNTHETIC_NODES; ++i) {
+        snprintf(synthetic[i], sizeof(synthetic[i]), "stop_%d", i);
+        synthetic_ids[i] = synthetic[i];
+    }
+    benchmark("stops", synthetic_ids, SYNTHETIC_NODES);
+
+    free(synthetic_ids);
+    free(synthetic);
+    free(route_ids);
+    free(node_ids);
+    delete_network(network);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @brief Scaling of the whole network optimization over threads
+ *
+ * Books random reservations on the intercity test network and optimizes all
+ * trips with 1, 2, 4, ... up to the given number of threads.
+ *
+ * Compile:
+ *  gcc -O2 network_benchmark.c -o network_benchmark -losurs-io -losurs-network -losurs-ds -losurs-reserve -losurs-optimize -losurs-olal -lxml2 -lpthread
+ *
+ * Usage:
+ *  ./network_benchmark [max_threads]
+ *
+ * @file network_benchmark.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <osurs/io.h>
+#include <osurs/olal.h>
+#include <stdio.h>
+#include <time.h>
+
+#define RESERVATIONS 200000
+#define RUNS 5
+
+// Elapsed time in milliseconds.
+static double elapsed_ms(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e3 +
+           (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : 8;
+
+    // read network
+    Network *network = new_network();
+    if (!import_network(network, "../tests/input/intercity_network.xml")) {
+        perror("Could not load network");
+        return 1;
+    }
+
+    // create random reservations
+    srand(42);
+    for (int i = 0; i < RESERVATIONS; ++i) {
+        Node *orig = hash_map_get_random(network->nodes);
+        Node *dest = hash_map_get_random(network->nodes);
+        int dep = rand() % (24 * 60 * 60) + 1;
+        Connection *conn = new_connection(orig, dest, dep);
+        new_reservation(conn, rand() % 3 + 1, NULL);
+        delete_connection(conn);
+    }
+
+    printf("%8s %12s %8s\n", "threads", "time [ms]", "speedup");
+    double base = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double total = 0;
+        for (int run = 0; run < RUNS; ++run) {
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            NetworkOptimization *result =
+                optimize_network(network, OPTIMIZE_COMPACT, threads);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            total += elapsed_ms(&start, &end);
+            delete_network_optimization(result);
+        }
+        if (threads == 1) base = total;
+        printf("%8d %12.2f %8.2f\n", threads, total / RUNS, base / total);
+    }
+
+    delete_network(network);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @brief Latency and quality benchmark of the optimization strategies
+ *
+ * Creates random reservations on a synthetic trip until it is almost fully
+ * booked and optimizes them with every registered strategy. Prints the mean
+ * latency per call and the number of reserved seats that could not be placed.
+ *
+ * Compile:
+ *  gcc -O2 optimize_benchmark.c -o optimize_benchmark -losurs-optimize
+ *
+ * @file optimize_benchmark.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <osurs/optimize.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SEATS 400
+#define SEGMENTS 24
+#define RUNS 50
+#define ATTEMPTS 20000
+
+// Elapsed time in microseconds.
+static double elapsed_us(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e6 +
+           (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    static unsigned int res_arr[SEATS * SEGMENTS];
+    static unsigned int work_arr[SEATS * SEGMENTS];
+    static int res_ids[SEATS * SEGMENTS];
+    int seat_ids[SEATS];
+    int load[SEGMENTS] = {0};
+    int res_count = 0;
+
+    for (int i = 0; i < SEATS; ++i) seat_ids[i] = i + 100;
+
+    // create random group reservations as long as they fit
+    srand(42);
+    for (int res_id = 0; res_id < ATTEMPTS; ++res_id) {
+        int orig = rand() % SEGMENTS;
+        int dest = orig + 1 + rand() % (SEGMENTS - orig);
+        int seats = rand() % 4 + 1;
+        int fits = 1;
+        for (int s = orig; s < dest; ++s) fits &= load[s] + seats <= SEATS;
+        if (!fits) continue;
+        unsigned int mask = 0;
+        for (int s = orig; s < dest; ++s) {
+            load[s] += seats;
+            mask |= 1u << s;
+        }
+        for (int k = 0; k < seats && res_count < SEATS * SEGMENTS; ++k) {
+            res_arr[res_count] = mask;
+            res_ids[res_count++] = res_id;
+        }
+    }
+
+    printf("%d reserved seats on %d seats and %d segments, %d runs\n\n",
+           res_count, SEATS, SEGMENTS, RUNS);
+    printf("%-16s %14s %10s\n", "strategy", "latency [us]", "unplaced");
+
+    for (int i = 0; i < OPTIMIZE_STRATEGY_COUNT; ++i) {
+        const OptimizeStrategyInfo *info =
+            get_optimize_strategy((OptimizeStrategy)i);
+        double total = 0;
+        int unplaced = 0;
+        for (int run = 0; run < RUNS; ++run) {
+            struct timespec start, end;
+            memcpy(work_arr, res_arr, sizeof(unsigned int) * res_count);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            SeatCollection *collection = optimize_reservation_with(
+                info->strategy, work_arr, res_count, res_ids, SEGMENTS,
+                seat_ids, SEATS);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            total += elapsed_us(&start, &end);
+            delete_seat_collection(collection);
+        }
+        for (int j = 0; j < res_count; ++j) unplaced += work_arr[j] != 0;
+        printf("%-16s %14.1f %10d\n", info->name, total / RUNS, unplaced);
+    }
+
+    return 0;
+}
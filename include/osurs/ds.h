@@ -4,6 +4,9 @@
  * This header file contains a collection of data structures that are designed
  * to handle and manipulate data in an efficient manner. The data structures
  * included in this file are:
+ *  - @b Arena: A region-based allocator, which hands out memory from large
+ * blocks and releases it as a whole. Arenas are useful for many small objects
+ * with the same lifetime, since allocation and teardown are cheap.
  *  - @b ArrayList: A dynamic array data structure that automatically resizes
  * itself as elements are added or removed. Array lists are useful for
  * situations where fast random access to elements is required, as they provide
@@ -22,6 +25,9 @@
  *  - @b Queue: A linear data structure that follows the first-in, first-out
  * (FIFO) principle. Queues are useful for situations where it is necessary to
  * process items in the order in which they were received.
+ *  - @b StringPool: A string interning pool, which stores every distinct string
+ * once in large blocks. Interned strings can be compared by pointer and are
+ * released in bulk, which is useful for many repeated identifiers.
  *  - @b Stack: A linear data structure that follows the last-in, first-out
  * (LIFO) principle. Stacks are useful for situations where it is necessary to
  * process items in the reverse order in which they were received.
@@ -34,11 +40,13 @@
 #ifndef OSURS_DS_H_
 #define OSURS_DS_H_
 
+#include "osurs/ds/arena.h"
 #include "osurs/ds/arraylist.h"
 #include "osurs/ds/hashmap.h"
 #include "osurs/ds/linkedlist.h"
 #include "osurs/ds/priority.h"
 #include "osurs/ds/queue.h"
 #include "osurs/ds/stack.h"
+#include "osurs/ds/strpool.h"
 
 #endif  // OSURS_DS_H_
\ No newline at end of file
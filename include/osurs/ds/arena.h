@@ -0,0 +1,91 @@
+/**
+ * @brief Arena data structure
+ *
+ * Region-based memory allocator (bump allocator). Memory is handed out from
+ * large blocks by increasing an offset and is only released as a whole when
+ * the arena is freed, which makes allocations and teardown cheap for many
+ * small objects with the same lifetime.
+ *
+ * Note: Memory of single allocations cannot be released or reallocated. This
+ * implementation is not thread-safe.
+ *
+ * @file arena.h
+ * @date 2026-10-18
+ * @author Merlin Unterfinger
+ */
+
+#ifndef OSURS_DS_ARENA_H_
+#define OSURS_DS_ARENA_H_
+
+#include <stddef.h>
+
+/**
+ * @brief Block of the arena.
+ *
+ * A block holds the memory of many allocations back to back.
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock* next; /**< NULL or the previously filled block. */
+    size_t capacity;         /**< Number of bytes of the block. */
+    size_t used;             /**< Number of used bytes. */
+} ArenaBlock;
+
+/**
+ * @brief An arena.
+ *
+ * The blocks grow geometrically, so the number of blocks is logarithmic in
+ * the allocated memory.
+ */
+typedef struct Arena {
+    ArenaBlock* blocks; /**< Current block, linked to the filled ones. */
+    size_t block_count; /**< Number of blocks. */
+    size_t allocated;   /**< Number of bytes handed out. */
+    size_t reserved;    /**< Number of bytes of all blocks. */
+} Arena;
+
+/**
+ * @brief Create an arena on the heap.
+ *
+ * @return Arena*
+ */
+Arena* arena_create();
+
+/**
+ * @brief Allocate memory from the arena.
+ *
+ * The memory is aligned for any type and valid until the arena is freed.
+ *
+ * @param arena An arena.
+ * @param size The number of bytes.
+ * @return void* Pointer to the uninitialized memory.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from the arena.
+ *
+ * @param arena An arena.
+ * @param count The number of elements.
+ * @param size The number of bytes of an element.
+ * @return void* Pointer to the memory set to zero.
+ */
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+
+/**
+ * @brief Get the bytes used by an allocation.
+ *
+ * Allocations are rounded up to the alignment of the arena.
+ *
+ * @param size The number of bytes requested.
+ * @return size_t The number of bytes taken from the arena.
+ */
+size_t arena_alloc_size(size_t size);
+
+/**
+ * @brief Free the arena and all memory allocated from it.
+ *
+ * @param arena An arena.
+ */
+void arena_free(Arena* arena);
+
+#endif  // OSURS_DS_ARENA_H_
@@ -1,10 +1,22 @@
 /**
  * @brief Hashmap data structure
  *
- * Map abstract data type (ADT) implementation as a hashmap. The implementation
- * uses closed-addressing (separate chaining) to handle duplicate index values.
- * A bucket of the hashmap contains an entry, which can hold a reference to the
- * next entry in the same bucket.
+ * Map abstract data type (ADT) implementation as a hashmap. By default the
+ * implementation uses closed-addressing (separate chaining) to handle duplicate
+ * index values. A bucket of the hashmap contains an entry, which can hold a
+ * reference to the next entry in the same bucket.
+ *
+ * A map can be switched to open addressing, which stores the entries inline in
+ * an array and refers to them from a power of two table of slots (Swiss
+ * table). A control byte per slot holds 7 bits of the key hash, a group of 16
+ * control bytes is compared at once (SSE2 if available) to find the candidate
+ * slots before any key is compared.
+ *
+ * Both store the full 64 bit hash of the key with the entry, so resizing does
+ * not hash the keys again and only keys with equal hashes are compared. Both
+ * keep the entries in a dense array without gaps (the last entry moves into
+ * the gap of a removed one), which allows to draw random entries in constant
+ * time.
  *
  * Note: This is not a multimap, entries on existing keys are replaced. This
  * implementation is not thread-safe.
@@ -28,21 +40,65 @@
 typedef struct HashMapEntry {
     char* key;                 /**< Key of the entry. */
     void* value;               /**< Value of the entry. */
+    unsigned long long hash;   /**< Full hash of the key. */
+    size_t position;           /**< Position in the dense array. */
     struct HashMapEntry* next; /**< NULL or the next entry in the bucket. */
 } HashMapEntry;
 
+/**
+ * @brief Entry of an open-addressing hashmap.
+ *
+ * The entries are stored in a dense array, the slots of the table refer to
+ * them by their index.
+ */
+typedef struct HashMapSlot {
+    char* key;               /**< Key of the entry. */
+    void* value;             /**< Value of the entry. */
+    unsigned long long hash; /**< Full hash of the key. */
+} HashMapSlot;
+
 /**
  * @brief A hashmap.
  *
- * Abstract data type (ADT) map implementation as a hashmap.
+ * Abstract data type (ADT) map implementation as a hashmap. The buckets and
+ * the dense entry pointers are only used by chained maps, the control bytes,
+ * indices and slots only by open-addressing maps.
  */
 typedef struct HashMap {
-    HashMapEntry** entries; /**< Buckets for the entries. */
+    HashMapEntry** entries; /**< Buckets for the entries (chained). */
+    HashMapEntry** dense;   /**< All entries without gaps (chained). */
     size_t size;            /**< Number of entries in the hashmap. */
-    size_t capacity;        /**< Bucket capacity of the hashmap. */
+    size_t capacity;        /**< Bucket or slot capacity of the hashmap. */
+    size_t reserved;        /**< Entries the capacity is kept for. */
     int dynamic_alloc;      /**< Where is the map stored: 0=stack, 1=heap. */
+    int borrow_keys;        /**< Are keys copied: 0=copied, 1=borrowed. */
+    int open_addressing;    /**< Collisions: 0=chained, 1=open addressing. */
+    unsigned char* control; /**< Control byte of each slot (open). */
+    unsigned int* indices;  /**< Entry index of each used slot (open). */
+    HashMapSlot* slots;     /**< All entries without gaps (open). */
+    size_t deleted;         /**< Number of deleted slots (open). */
 } HashMap;
 
+/**
+ * @brief Cursor over the entries of a hashmap.
+ *
+ * The entries are visited in the order of the dense array of the hashmap,
+ * which is the insertion order until entries are removed. The hashmap must not
+ * be modified during the iteration, except for changing values with
+ * hash_map_put().
+ */
+typedef struct HashMapIterator {
+    const HashMap* map; /**< The iterated hashmap. */
+    size_t position;    /**< Position of the next entry. */
+    const char* key;    /**< Key of the current entry. */
+    void* value;        /**< Value of the current entry. */
+} HashMapIterator;
+
+/**
+ * @brief Callback of hash_map_for_each().
+ */
+typedef void (*HashMapCallback)(const char* key, void* value, void* context);
+
 /**
  * @brief Initialize the hashmap.
  *
@@ -57,13 +113,62 @@ void hash_map_init(HashMap* map);
  */
 HashMap* hash_map_create();
 
+/**
+ * @brief Create a hashmap on the heap for a known number of entries.
+ *
+ * Like hash_map_create() followed by hash_map_reserve().
+ *
+ * @param count The number of entries to reserve.
+ * @return HashMap*
+ */
+HashMap* hash_map_create_with_capacity(size_t count);
+
+/**
+ * @brief Reserve the capacity for a number of entries.
+ *
+ * Grows the hashmap once, so that the given number of entries can be put
+ * without resizing. Removing entries does not shrink the capacity below the
+ * reserved number of entries. Can be called before or after switching to open
+ * addressing.
+ *
+ * @param map A hashmap.
+ * @param count The number of entries to reserve.
+ */
+void hash_map_reserve(HashMap* map, size_t count);
+
+/**
+ * @brief Borrow the keys instead of copying them.
+ *
+ * The keys passed to hash_map_put() are stored as they are and not freed by
+ * the hashmap, the caller has to keep them alive as long as the entries exist
+ * (e.g. interned strings). Has to be called on an empty hashmap.
+ *
+ * @param map A hashmap.
+ */
+void hash_map_borrow_keys(HashMap* map);
+
+/**
+ * @brief Use open addressing instead of separate chaining.
+ *
+ * The entries are stored inline in an array, which avoids an allocation per
+ * entry and the chain walk of a lookup. The power of two table of slots is
+ * probed in groups of 16 control bytes, the table grows when 7/8 of the slots
+ * are used.
+ * The entries of a non-empty hashmap are moved into the slots in insertion
+ * order.
+ *
+ * @param map A hashmap.
+ */
+void hash_map_open_addressing(HashMap* map);
+
 /**
  * @brief Put a new entry into the hashmap.
  *
  * Puts the entry into the bucket at the index (hash value) of the key. If the
  * bucket is not empty, new entry is created and placed to the beginning of the
- * chain. Then the old entry in the array is replaced with the new entry. If a
- * key already exists, the value is replaced.
+ * chain. Then the old entry in the array is replaced with the new entry. An
+ * open-addressing map stores the entry in the first free slot on the probe
+ * sequence of the key. If a key already exists, the value is replaced.
  *
  * @param map A hashmap.
  * @param key The key.
@@ -87,20 +192,86 @@ void* hash_map_get(HashMap* map, const char* key);
  * @brief Get a random value.
  *
  * Returns a random void pointer to a value or NULL if the hashmap is empty.
+ * The value is drawn uniformly in constant time from the dense array of the
+ * entries, using the global rand().
  *
  * @param map A hashmap.
  * @return void*
  */
 void* hash_map_get_random(HashMap* map);
 
+/**
+ * @brief Get a random value using a random state of the caller.
+ *
+ * Like hash_map_get_random(), but advances the given state instead of the
+ * global rand() state, so several threads can draw values from the same
+ * hashmap as long as it is not modified. Any value is a valid seed.
+ *
+ * @param map A hashmap.
+ * @param state The state of the random generator, updated by the call.
+ * @return void*
+ */
+void* hash_map_get_random_with(HashMap* map, unsigned long long* state);
+
 /**
  * @brief Remove an entry from the hashmap.
  *
+ * The capacity is halved once less than 1/8 of it is used, but not below the
+ * reserved capacity, so alternating puts and removes do not resize the table.
+ *
  * @param map A hashmap structure.
  * @param key The key.
  */
 void hash_map_remove(HashMap* map, const char* key);
 
+/**
+ * @brief Start an iteration over the entries of the hashmap.
+ *
+ * Example:
+ *
+ *  HashMapIterator iter;
+ *  hash_map_iter_begin(map, &iter);
+ *  while (hash_map_iter_next(&iter)) printf("%s\n", iter.key);
+ *
+ * @param map A hashmap.
+ * @param iter The iterator to initialize.
+ */
+void hash_map_iter_begin(const HashMap* map, HashMapIterator* iter);
+
+/**
+ * @brief Advance the iterator to the next entry.
+ *
+ * Sets the key and value of the iterator to the next entry.
+ *
+ * @param iter An iterator started with hash_map_iter_begin().
+ * @return int 1 if there was a next entry, 0 at the end of the hashmap.
+ */
+int hash_map_iter_next(HashMapIterator* iter);
+
+/**
+ * @brief Call a function on each entry of the hashmap.
+ *
+ * The entries are visited in the same order as with an iterator.
+ *
+ * @param map A hashmap.
+ * @param callback The function called with the key, the value and the context.
+ * @param context Passed to the callback, e.g. an accumulator.
+ */
+void hash_map_for_each(const HashMap* map, HashMapCallback callback,
+                       void* context);
+
+/**
+ * @brief Get the memory of the hashmap.
+ *
+ * Sums the bytes of the bucket and dense arrays and the entries (chained) or
+ * the control bytes, the slots and the entries (open addressing) and the
+ * hashmap itself if it is located on the heap. Copied keys are not included.
+ *
+ * @param map A hashmap.
+ * @return size_t The number of bytes.
+ */
+size_t hash_map_memory(const HashMap* map);
+
 /**
  * @brief Print the hashmap content.
  *
@@ -0,0 +1,81 @@
+/**
+ * @brief String pool data structure
+ *
+ * String interning pool, which stores every distinct string once in large
+ * blocks (arena) and returns the same canonical pointer for equal strings.
+ * Interned strings can therefore be compared by pointer and are released in
+ * bulk with the pool.
+ *
+ * Note: This implementation is not thread-safe.
+ *
+ * @file strpool.h
+ * @date 2026-10-18
+ * @author Merlin Unterfinger
+ */
+
+#ifndef OSURS_DS_STRPOOL_H_
+#define OSURS_DS_STRPOOL_H_
+
+#include <stddef.h>
+
+#include "osurs/ds/hashmap.h"
+
+/**
+ * @brief Block of the string pool.
+ *
+ * A block holds the characters of many interned strings back to back.
+ */
+typedef struct StringPoolBlock {
+    struct StringPoolBlock* next; /**< NULL or the previously filled block. */
+    size_t capacity;              /**< Number of characters of the block. */
+    size_t used;                  /**< Number of used characters. */
+    char data[];                  /**< Characters of the strings. */
+} StringPoolBlock;
+
+/**
+ * @brief A string pool.
+ *
+ * Abstract data type (ADT) for interning strings.
+ */
+typedef struct StringPool {
+    HashMap strings;         /**< Interned strings (borrowed keys). */
+    StringPoolBlock* blocks; /**< Current block, linked to the filled ones. */
+    size_t bytes;            /**< Number of characters of all strings. */
+} StringPool;
+
+/**
+ * @brief Create a string pool on the heap.
+ *
+ * @return StringPool*
+ */
+StringPool* string_pool_create();
+
+/**
+ * @brief Intern a string.
+ *
+ * Returns the canonical copy of the string, which is copied into the pool if
+ * the string is not yet interned.
+ *
+ * @param pool A string pool.
+ * @param str The string.
+ * @return const char* The interned string, valid until the pool is freed.
+ */
+const char* string_pool_intern(StringPool* pool, const char* str);
+
+/**
+ * @brief Find an interned string.
+ *
+ * @param pool A string pool.
+ * @param str The string.
+ * @return const char* The interned string or NULL if it is not interned.
+ */
+const char* string_pool_find(StringPool* pool, const char* str);
+
+/**
+ * @brief Free the string pool and all interned strings.
+ *
+ * @param pool A string pool.
+ */
+void string_pool_free(StringPool* pool);
+
+#endif  // OSURS_DS_STRPOOL_H_
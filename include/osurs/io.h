@@ -54,6 +54,19 @@ int export_network(Network *network, const char *filename);
  */
 int export_reservations(Network *network, const char *filename);
 
+/**
+ * @brief Export the reservations of a network snapshot to xml.
+ *
+ * Exports the reservations booked before the snapshot was taken, while
+ * bookings can continue on the network (see network_snapshot()).
+ *
+ * @param snapshot The snapshot to export the reservations.
+ * @param filename The file to create.
+ * @return 1 if success, 0 if failure.
+ */
+int export_reservations_snapshot(NetworkSnapshot *snapshot,
+                                 const char *filename);
+
 // io/matsim
 
 /**
@@ -124,6 +137,13 @@ void print_route(Route *route, int indent);
  */
 void print_network(Network *network);
 
+/**
+ * @brief Print network with the reservations of a snapshot.
+ *
+ * @param snapshot The snapshot to print (see network_snapshot()).
+ */
+void print_network_snapshot(NetworkSnapshot *snapshot);
+
 /**
  * @brief Print connection.
  *
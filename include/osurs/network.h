@@ -97,6 +97,63 @@ Route *new_route(Network *network, const char *id, Node *nodes[],
                  size_t route_size, const char *trip_ids[], int departures[],
                  Vehicle *vehicles[], size_t trip_size);
 
+/**
+ * @brief Create a new service calendar and add it to the network.
+ *
+ * The calendar covers the dates first_day to first_day + day_count - 1 and
+ * has no service days until they are set with calendar_set_day().
+ *
+ * @param network The network to add the calendar.
+ * @param id The identifier of the calendar.
+ * @param first_day The first date of the calendar.
+ * @param day_count The number of dates of the calendar.
+ * @return A pointer to the newly allocated calendar (Calendar*).
+ */
+Calendar *new_calendar(Network *network, const char *id, int first_day,
+                       int day_count);
+
+/**
+ * @brief Create a new service day of a trip or get the existing one.
+ *
+ * Allocates the reservation counts and the reservations of the trip on a
+ * date. Called by new_reservation() on the first booking of the date.
+ *
+ * @param trip The trip.
+ * @param date The date.
+ * @return The service day or NULL if the trip does not run on the date.
+ */
+ServiceDay *new_service_day(Trip *trip, int date);
+
+// Service calendars
+
+/**
+ * @brief Set or clear a service day of a calendar.
+ *
+ * @param calendar The calendar.
+ * @param date The date, ignored if outside of the calendar.
+ * @param active 1 if the trips run on the date, 0 otherwise.
+ */
+void calendar_set_day(Calendar *calendar, int date, int active);
+
+/**
+ * @brief Check if a date is a service day of a calendar.
+ *
+ * @param calendar The calendar.
+ * @param date The date.
+ * @return 1 if the date is a service day, 0 otherwise.
+ */
+int calendar_has_day(const Calendar *calendar, int date);
+
+/**
+ * @brief Check if a trip runs on a date.
+ *
+ * @param trip The trip.
+ * @param date The date.
+ * @return 1 if the trip has no calendar or the date is a service day of its
+ * calendar, 0 otherwise.
+ */
+int trip_runs_on(const Trip *trip, int date);
+
 // Getters
 
 /**
@@ -135,15 +192,273 @@ Composition *get_composition(Network *network, const char *id);
  */
 Route *get_route(Network *network, const char *id);
 
+/**
+ * @brief Get the calendar struct.
+ *
+ * @param network An network to get the calendar from.
+ * @param id The identifier of the calendar.
+ * @return Returns the calendar or NULL if not found.
+ */
+Calendar *get_calendar(Network *network, const char *id);
+
+/**
+ * @brief Get the service day of a trip.
+ *
+ * Binary search on the booked service days of the trip.
+ *
+ * @param trip A trip to get the service day from.
+ * @param date The date.
+ * @return Returns the service day or NULL if nothing is booked on the date.
+ */
+ServiceDay *get_service_day(Trip *trip, int date);
+
 /**
  * @brief Get the trip struct.
  *
+ * Binary search on the trips of the route sorted by identifier. If several
+ * trips share the identifier, the first trip on the route is returned.
+ *
  * @param route A route to get the trip from.
  * @param id The identifier of the trip.
  * @return Trip* Returns the trip.
  */
 Trip *get_trip(Route *route, const char *id);
 
+/**
+ * @brief Get a node by its index.
+ *
+ * Nodes are numbered densely in the order of creation (Node.index), which
+ * allows to refer to them by integer handles instead of identifiers.
+ *
+ * @param network A network to get the node from.
+ * @param index The index of the node.
+ * @return Returns the node or NULL if the index is out of range.
+ */
+Node *network_node_at(Network *network, int index);
+
+/**
+ * @brief Get a route by its index.
+ *
+ * @param network A network to get the route from.
+ * @param index The index of the route (Route.index).
+ * @return Returns the route or NULL if the index is out of range.
+ */
+Route *network_route_at(Network *network, int index);
+
+/**
+ * @brief Get a trip by its index.
+ *
+ * The trips of a route have consecutive indices, starting at the index of the
+ * root trip in the order of the trips on the route.
+ *
+ * @param network A network to get the trip from.
+ * @param index The index of the trip (Trip.index).
+ * @return Returns the trip or NULL if the index is out of range.
+ */
+Trip *network_trip_at(Network *network, int index);
+
+/**
+ * @brief Get a vehicle by its index.
+ *
+ * @param network A network to get the vehicle from.
+ * @param index The index of the vehicle (Vehicle.index).
+ * @return Returns the vehicle or NULL if the index is out of range.
+ */
+Vehicle *network_vehicle_at(Network *network, int index);
+
+// Snapshots
+
+/**
+ * @brief Take a snapshot of the reservations of a network
+ *
+ * Readers of the snapshot see the reservation counts and reservations of the
+ * network at the time of the snapshot, while bookings continue on the
+ * network. The structure of the network is shared; the reserved array of a
+ * stop is shared until the first booking on the stop, which copies it
+ * (copy-on-write, see stop_reserved_for_write()); the same holds for the
+ * booked service days. The reservation and service day lists are shared
+ * with their length, bookings append behind it and copy a shared list only
+ * when it is full (see trip_reservations_for_write()). Taking a snapshot
+ * copies one pointer per stop and one pointer and length per list of the trips
+ * and service days, independent of the number of reservations.
+ *
+ * @note Bookings (new_reservation()) and taking and deleting snapshots are
+ * serialized by the lock of the network. Reading a snapshot, e.g. with
+ * export_reservations_snapshot(), needs no lock and may run in another thread
+ * while bookings continue. Connection searches take the lock to look up the
+ * service days of dated trips; the seat counts they read may be outdated,
+ * new_reservation() checks them again under the lock. Optimizations are not
+ * synchronized with bookings.
+ *
+ * @param network The network.
+ * @return A pointer to the snapshot, to be released with
+ * delete_network_snapshot() or at the latest by delete_network().
+ */
+NetworkSnapshot *network_snapshot(Network *network);
+
+/**
+ * @brief Get the reservation count of a stop and trip in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param stop A stop of the network.
+ * @param trip A trip on the route of the stop.
+ * @return The number of reserved seats at the time of the snapshot.
+ */
+int snapshot_reserved(NetworkSnapshot *snapshot, Stop *stop, Trip *trip);
+
+/**
+ * @brief Get the number of reservations of a trip in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param trip A trip of the network.
+ * @return The number of reservations at the time of the snapshot.
+ */
+size_t snapshot_reservation_count(NetworkSnapshot *snapshot, Trip *trip);
+
+/**
+ * @brief Get a reservation of a trip in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param trip A trip of the network.
+ * @param i The position of the reservation on the trip.
+ * @return The reservation or NULL if it was booked after the snapshot.
+ */
+Reservation *snapshot_reservation(NetworkSnapshot *snapshot, Trip *trip,
+                                  size_t i);
+
+/**
+ * @brief Get the number of booked service days of a trip in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param trip A trip of the network.
+ * @return The number of service days booked at the time of the snapshot.
+ */
+int snapshot_service_day_count(NetworkSnapshot *snapshot, Trip *trip);
+
+/**
+ * @brief Get a booked service day of a trip in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param trip A trip of the network.
+ * @param i The position of the service day on the trip, sorted by date.
+ * @return The service day or NULL if it was booked after the snapshot.
+ */
+ServiceDay *snapshot_service_day(NetworkSnapshot *snapshot, Trip *trip,
+                                 int i);
+
+/**
+ * @brief Get the reservation count of a stop on a service day in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param day A service day of a trip.
+ * @param stop A stop on the route of the trip.
+ * @return The number of reserved seats at the time of the snapshot.
+ */
+int snapshot_service_day_reserved(NetworkSnapshot *snapshot, ServiceDay *day,
+                                  Stop *stop);
+
+/**
+ * @brief Get the number of reservations of a service day in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param day A service day of a trip.
+ * @return The number of reservations at the time of the snapshot.
+ */
+size_t snapshot_service_day_reservation_count(NetworkSnapshot *snapshot,
+                                              ServiceDay *day);
+
+/**
+ * @brief Get a reservation of a service day in a snapshot.
+ *
+ * @param snapshot The snapshot.
+ * @param day A service day of a trip.
+ * @param i The position of the reservation on the service day.
+ * @return The reservation or NULL if it was booked after the snapshot.
+ */
+Reservation *snapshot_service_day_reservation(NetworkSnapshot *snapshot,
+                                              ServiceDay *day, size_t i);
+
+/**
+ * @brief Get the reserved array of a stop for writing.
+ *
+ * Copies the reserved array of the stop if a snapshot shares it. Every write
+ * to Stop.reserved has to go through this function, with the lock of the
+ * network held (see new_reservation()).
+ *
+ * @param route The route of the stop.
+ * @param stop The stop to write.
+ * @return The reserved array of the stop, which is not shared.
+ */
+int *stop_reserved_for_write(Route *route, Stop *stop);
+
+/**
+ * @brief Get the reserved array of a service day for writing.
+ *
+ * Same as stop_reserved_for_write() for the reservation counts of a service
+ * day.
+ *
+ * @param day The service day to write.
+ * @return The reserved array of the service day, which is not shared.
+ */
+int *service_day_reserved_for_write(ServiceDay *day);
+
+/**
+ * @brief Get the reservation list of a trip for appending.
+ *
+ * Copies the elements array of the list if it is full and a snapshot shares
+ * it, so appending does not move the array the snapshot reads. Every append
+ * to Trip.reservations has to go through this function, with the lock of the
+ * network held (see new_reservation()).
+ *
+ * @param trip The trip to book.
+ * @return The reservation list of the trip, to append one reservation.
+ */
+ArrayList *trip_reservations_for_write(Trip *trip);
+
+/**
+ * @brief Get the reservation list of a service day for appending.
+ *
+ * Same as trip_reservations_for_write() for the reservations of a service
+ * day.
+ *
+ * @param day The service day to book.
+ * @return The reservation list of the service day, to append one reservation.
+ */
+ArrayList *service_day_reservations_for_write(ServiceDay *day);
+
+/**
+ * @brief Get the service day array of a trip for inserting.
+ *
+ * Grows the array if it is full and copies it if a snapshot shares it, since
+ * the service days are inserted sorted by date (see new_service_day()).
+ *
+ * @param trip The trip.
+ * @return The service day array of the trip, with room for one more day.
+ */
+ServiceDay **trip_service_days_for_write(Trip *trip);
+
+/**
+ * @brief Delete a snapshot
+ *
+ * Frees the snapshot and the reserved arrays only it shared.
+ *
+ * @param snapshot The snapshot to delete.
+ */
+void delete_network_snapshot(NetworkSnapshot *snapshot);
+
+/**
+ * @brief Get the memory usage of a network.
+ *
+ * Reports the number of objects and the bytes allocated per category, computed
+ * from the sizes the library allocates: arena allocations are rounded to the
+ * arena alignment, growable arrays are counted with their capacity. Cached
+ * seat collections of the trips are included, the allocator overhead is not.
+ *
+ * @param network The network.
+ * @return The memory usage per category.
+ */
+NetworkMemoryStats network_memory_stats(Network *network);
+
 // Destructor-like methods
 
 /**
@@ -157,4 +472,103 @@ Trip *get_trip(Route *route, const char *id);
  */
 void delete_network(Network *network);
 
+/**
+ * @brief Partition a network by route into shards
+ *
+ * Copies every route with its trips and reservations into the network of its
+ * shard, together with the nodes, vehicles, compositions and calendars it
+ * uses. Identifiers are kept, so each shard can be exported and imported on
+ * its own (export_network(), export_reservations()) and serves the bookings
+ * of its routes without coordination with the other shards. Without an
+ * assignment, the routes are balanced by their number of stops times trips
+ * (largest first onto the smallest shard), which is deterministic for a
+ * network.
+ *
+ * @param network The network to partition.
+ * @param shard_count The number of shards (at least 1).
+ * @param route_shards The shard of each route index (e.g. to keep route
+ * groups together) or NULL to balance the routes.
+ * @return A pointer to the shards or NULL if the shard count or an assignment
+ * is out of range.
+ */
+NetworkShards *shard_network(Network *network, int shard_count,
+                             const int route_shards[]);
+
+/**
+ * @brief Get the shards serving a connection between two nodes
+ *
+ * A connection without transfers runs on a route passing both nodes, so only
+ * shards serving both nodes can have it.
+ *
+ * @param shards The shards.
+ * @param orig The origin node of the source network.
+ * @param dest The destination node of the source network.
+ * @param result Array of at least shard_count entries for the shards.
+ * @return The number of shards written to result.
+ */
+int shards_serving(NetworkShards *shards, const Node *orig, const Node *dest,
+                   int result[]);
+
+/**
+ * @brief Delete the shards of a network
+ *
+ * Frees the networks of the shards and the routing table, the source network
+ * is not changed.
+ *
+ * @param shards The shards to delete.
+ */
+void delete_network_shards(NetworkShards *shards);
+
+/**
+ * @brief Freeze a network for fast queries
+ *
+ * Compiles the network into an immutable, contiguous struct-of-arrays view
+ * (see FrozenNetwork) for the connection search (frozen_new_connection()).
+ * Reservations can still be booked; the view keeps its own contiguous copy of
+ * the reservation counts, which new_reservation() updates together with the
+ * network (see frozen_network_reserve()).
+ *
+ * @note The view is invalid after nodes or routes are added to the network
+ * and has to be frozen again. It has to be released with
+ * delete_frozen_network() before the network is deleted.
+ *
+ * @param network The network to freeze.
+ * @return A pointer to the frozen network.
+ */
+FrozenNetwork *freeze_network(Network *network);
+
+/**
+ * @brief Get the index of a node in a frozen network
+ *
+ * @param frozen The frozen network.
+ * @param node The node.
+ * @return The node index or -1 if the node is not part of the view.
+ */
+int frozen_node_index(FrozenNetwork *frozen, const Node *node);
+
+/**
+ * @brief Add booked seats to the frozen views of a network
+ *
+ * Adds the seats to the reservation counts of the trip from the origin to the
+ * destination stop in every live view of the network of the trip. Called by
+ * new_reservation() with the lock of the network held.
+ *
+ * @param trip The booked trip.
+ * @param orig The boarding stop.
+ * @param dest The alighting stop.
+ * @param seats The number of booked seats.
+ */
+void frozen_network_reserve(Trip *trip, const Stop *orig, const Stop *dest,
+                            int seats);
+
+/**
+ * @brief Delete a frozen network
+ *
+ * Frees the arrays of the view and stops the bookings from updating it, the
+ * network is not touched otherwise.
+ *
+ * @param frozen The frozen network to delete.
+ */
+void delete_frozen_network(FrozenNetwork *frozen);
+
 #endif  // OSURS_NETWORK_H_
\ No newline at end of file
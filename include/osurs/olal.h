@@ -18,10 +18,273 @@
 /**
  * @brief Optimize seat reservations on given trip
  *
+ * Uses the sparsest distribution strategy (OPTIMIZE_SPARSEST).
+ *
  * @param t The trip that needs to be optimized.
  *
  * @return A pointer to the optimized seat collection.
  **/
 SeatCollection* optimize_trip(Trip* t);
 
+/**
+ * @brief Optimize seat reservations on given trip with a strategy
+ *
+ * Selects the kernel of the strategy specialized for the number of segments
+ * on the route (up to 32 or up to 64 segments).
+ *
+ * @param t The trip that needs to be optimized.
+ * @param strategy The optimization strategy.
+ *
+ * @return A pointer to the optimized seat collection or NULL if the trip has
+ * no reservations or more than 64 segments.
+ **/
+SeatCollection* optimize_trip_with(Trip* t, OptimizeStrategy strategy);
+
+/**
+ * @brief Optimize seat reservations on given trip, reusing the last result
+ *
+ * Returns the cached collection of the trip in O(1) if neither the
+ * reservations (tracked by the trip version, which new_reservation()
+ * increments) nor the strategy changed since it was computed. Otherwise the
+ * trip is optimized with optimize_trip_with() and the result is cached.
+ *
+ * @note The collection is owned by the trip and freed with the network; do not
+ * delete it. The cache is not synchronized, use it from one thread per trip.
+ *
+ * @param t The trip that needs to be optimized.
+ * @param strategy The optimization strategy.
+ *
+ * @return A pointer to the cached seat collection or NULL if the trip has no
+ * reservations or more than 64 segments.
+ **/
+SeatCollection* optimize_trip_cached(Trip* t, OptimizeStrategy strategy);
+
+/**
+ * @brief Optimize seat reservations on given trip into a workspace
+ *
+ * Same as optimize_trip_with(), but all buffers and the result are owned by
+ * the workspace (see optimize_reservation_in()). Once the workspace has grown
+ * to the largest trip, optimizing does not allocate. Use one workspace per
+ * thread.
+ *
+ * @param workspace The workspace.
+ * @param t The trip that needs to be optimized.
+ * @param strategy The optimization strategy.
+ *
+ * @return A pointer to the seat collection of the workspace, valid until the
+ * next call with the workspace, or NULL if the trip has no reservations or
+ * more than 64 segments.
+ **/
+SeatCollection* optimize_trip_in(OptimizeWorkspace* workspace, Trip* t,
+                                 OptimizeStrategy strategy);
+
+/**
+ * @brief Optimize seat reservations of a service day with a strategy
+ *
+ * Same as optimize_trip_with() for the reservations booked on a date (see
+ * new_connection_on()).
+ *
+ * @param day The service day that needs to be optimized.
+ * @param strategy The optimization strategy.
+ *
+ * @return A pointer to the optimized seat collection or NULL if the service
+ * day has no reservations or more than 64 segments.
+ **/
+SeatCollection* optimize_service_day(ServiceDay* day,
+                                     OptimizeStrategy strategy);
+
+/**
+ * @brief Optimize seat reservations on given trip within a time budget
+ *
+ * Improves the greedy group-adjacent solution until no group is split or the
+ * deadline is reached (see optimize_reservation_anytime()). The quality field
+ * of the collection reports the deadline, groups split and seat changes per
+ * passenger.
+ *
+ * @param t The trip that needs to be optimized.
+ * @param deadline_us The time budget in microseconds.
+ *
+ * @return A pointer to the optimized seat collection or NULL if the trip has
+ * no reservations or more than 64 segments.
+ **/
+SeatCollection* optimize_trip_anytime(Trip* t, long deadline_us);
+
+/**
+ * @brief Place new reservations without moving the existing ones
+ *
+ * Keeps every seat assignment of the previous collection fixed and only
+ * places the reservations booked on the trip since the previous optimization,
+ * side by side if possible and otherwise on the first free seats. The work is
+ * proportional to the number of new reservations, not to the trip size.
+ * Reserved seats which do not fit are counted in quality.unplaced.
+ *
+ * @note The previous collection must have been created by an optimize_trip
+ * function on the same trip and is updated in place. If it is the cached
+ * collection of the trip (see optimize_trip_cached()), the cache stays valid.
+ *
+ * @param t The trip with the new reservations.
+ * @param previous The previous seat collection of the trip or NULL, in which
+ * case the trip is optimized from scratch with OPTIMIZE_GROUP_ADJACENT.
+ *
+ * @return The updated previous collection (or a new one if previous was NULL)
+ * or NULL if the trip has more than 64 segments or previous was not optimized
+ * from the reservations of the trip (e.g. by optimize_service_day()).
+ **/
+SeatCollection* reoptimize_trip(Trip* t, SeatCollection* previous);
+
+/**
+ * @brief Place new reservations of a service day without moving the others
+ *
+ * Same as reoptimize_trip() for the reservations booked on a date.
+ *
+ * @note The previous collection must have been created by
+ * optimize_service_day() on the same service day and is updated in place.
+ *
+ * @param day The service day with the new reservations.
+ * @param previous The previous seat collection of the service day or NULL, in
+ * which case the day is optimized from scratch with OPTIMIZE_GROUP_ADJACENT.
+ *
+ * @return The updated previous collection (or a new one if previous was NULL)
+ * or NULL if the trip has more than 64 segments or previous was not optimized
+ * from the reservations of the service day.
+ **/
+SeatCollection* reoptimize_service_day(ServiceDay* day,
+                                       SeatCollection* previous);
+
+/**
+ * @brief Optimize seat reservations on all trips of a network
+ *
+ * The trips are distributed over a work-stealing thread pool, so that workers
+ * which finished their short regional trips take over the remaining long
+ * trips of busy workers.
+ *
+ * @note The network must not be modified during the optimization. The result
+ * has to be released with delete_network_optimization().
+ *
+ * @param network The network to optimize.
+ * @param strategy The optimization strategy.
+ * @param threads The number of threads (1 optimizes on the calling thread).
+ *
+ * @return A pointer to the flat result arrays.
+ **/
+NetworkOptimization* optimize_network(Network* network,
+                                      OptimizeStrategy strategy, int threads);
+
+/**
+ * @brief Optimize seat reservations on all trips in a departure window
+ *
+ * Same as optimize_network(), but only optimizes the trips departing at the
+ * root stop in the window [from, to).
+ *
+ * @param network The network to optimize.
+ * @param from The start of the window in seconds after midnight (included).
+ * @param to The end of the window in seconds after midnight (excluded).
+ * @param strategy The optimization strategy.
+ * @param threads The number of threads (1 optimizes on the calling thread).
+ *
+ * @return A pointer to the flat result arrays.
+ **/
+NetworkOptimization* optimize_network_window(Network* network, int from,
+                                             int to, OptimizeStrategy strategy,
+                                             int threads);
+
+/**
+ * @brief Delete a network optimization
+ *
+ * Frees the result arrays and all seat collections in it.
+ *
+ * @param result The network optimization to delete.
+ **/
+void delete_network_optimization(NetworkOptimization* result);
+
+/**
+ * @brief Create a departure-driven optimization scheduler
+ *
+ * Queues all trips of the network by the time they are due for optimization,
+ * which is their departure at the root stop minus the lead time, but not
+ * before midnight. The scheduler runs on the wall clock, in seconds since the
+ * local midnight of the day it was created, which keeps counting after 24:00
+ * for trips departing after midnight, until another clock is set with
+ * scheduler_set_clock(). Trips already due on the first run are optimized at
+ * once.
+ *
+ * @note The network must not be modified while the scheduler optimizes trips.
+ *
+ * @param network The network with the trips.
+ * @param lead_time The seconds before the departure a trip is optimized.
+ * @param strategy The optimization strategy.
+ * @param threads The number of worker threads.
+ *
+ * @return A pointer to the new scheduler.
+ **/
+Scheduler* new_scheduler(Network* network, int lead_time,
+                         OptimizeStrategy strategy, int threads);
+
+/**
+ * @brief Set the clock of a scheduler
+ *
+ * @param scheduler The scheduler.
+ * @param clock The clock, e.g. a simulated time for tests.
+ **/
+void scheduler_set_clock(Scheduler* scheduler, SchedulerClock clock);
+
+/**
+ * @brief Set the callback receiving the optimized trips
+ *
+ * Without a callback, the seat collections are deleted after the
+ * optimization.
+ *
+ * @param scheduler The scheduler.
+ * @param callback The callback (see SchedulerCallback).
+ * @param context The context passed to the callback.
+ **/
+void scheduler_set_callback(Scheduler* scheduler, SchedulerCallback callback,
+                            void* context);
+
+/**
+ * @brief Get the time the next trip is due
+ *
+ * Allows to wait exactly until the next optimization instead of polling.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return The due time in seconds after midnight or INT_MAX if all trips have
+ * been optimized.
+ **/
+int scheduler_next_due(Scheduler* scheduler);
+
+/**
+ * @brief Optimize all trips which are due
+ *
+ * Takes all trips due at the current time of the clock from the queue,
+ * optimizes them on the worker pool and passes the results to the callback.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return The number of optimized trips.
+ **/
+size_t scheduler_run_due(Scheduler* scheduler);
+
+/**
+ * @brief Run the scheduler until all trips are optimized
+ *
+ * Sleeps with the clock until the next trip is due and optimizes it, until
+ * the queue is empty.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return The number of optimized trips.
+ **/
+size_t scheduler_run(Scheduler* scheduler);
+
+/**
+ * @brief Delete a scheduler
+ *
+ * Stops the worker threads and frees the queue and the workspaces, the
+ * network is not touched.
+ *
+ * @param scheduler The scheduler to delete.
+ **/
+void delete_scheduler(Scheduler* scheduler);
+
 #endif  // OSURS_OLAL_H_
\ No newline at end of file
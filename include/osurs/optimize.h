@@ -66,6 +66,75 @@ SeatCollection* new_seat_collection(int seat_count, int seat_ids[]);
  */
 void delete_seat_collection(SeatCollection* collection);
 
+/**
+ * @brief Get the memory of a seat collection
+ *
+ * Sums the bytes allocated for the collection, its seats with their
+ * reservation arrays, the segment masks and the reverse index.
+ *
+ * @param collection The seat collection.
+ * @return The number of bytes.
+ */
+size_t seat_collection_memory(const SeatCollection* collection);
+
+/**
+ * @brief Build the reverse index of a seat collection
+ *
+ * Indexes the seats of every reservation id, replacing an existing index and
+ * reusing its arrays. The optimizations build the index of their results, so
+ * this is only needed after the seats of a collection were changed by hand
+ * (see seat_add_reservation()).
+ *
+ * @param collection The seat collection.
+ */
+void seat_collection_build_index(SeatCollection* collection);
+
+/**
+ * @brief Drop the reverse index of a seat collection
+ *
+ * Releases the index, e.g. to save its memory; lookups find no seats until
+ * the index is built again with seat_collection_build_index().
+ *
+ * @param collection The seat collection.
+ */
+void seat_collection_clear_index(SeatCollection* collection);
+
+/**
+ * @brief Find the seats of a reservation
+ *
+ * Looks up the reservation in the reverse index, which the optimizations
+ * build with their results, in expected O(1). The lookup does not modify the
+ * collection, so shared collections (see optimize_trip_cached()) can be
+ * queried from several threads. A reservation of several seats (or with seat
+ * changes) maps to several seat ids.
+ *
+ * @param collection The seat collection.
+ * @param res_id The reservation id.
+ * @param count Returns the number of seat ids.
+ * @return Returns the seat ids of the reservation (owned by the collection and
+ * valid until the index is rebuilt) or NULL if the reservation has no seat or
+ * the collection has no index.
+ */
+const int* seat_collection_find(const SeatCollection* collection, int res_id,
+                                int* count);
+
+/**
+ * @brief Find the free seats between two stops
+ *
+ * Tests the reserved segments of the seats of an optimized collection against
+ * the range of segments from stop from to stop to, 64 seats at a time.
+ *
+ * @param collection The optimized seat collection.
+ * @param from The ordinal of the boarding stop on the route (Stop.ordinal).
+ * @param to The ordinal of the alighting stop on the route.
+ * @param out[] Returns the ids of the free seats in seat order.
+ * @param max The maximum number of seat ids to return (length of out).
+ * @return Returns the number of free seats written to out, 0 for an invalid
+ * range.
+ */
+int find_free_seats(SeatCollection* collection, int from, int to, int out[],
+                    int max);
+
 /**
  * @brief Check if there is enough space available
  *
@@ -84,7 +153,8 @@ int space_available(unsigned int res_arr[], int res_count, int segment_count,
 /**
  * @brief Optimize the reservations
  *
- * Places the reservations on the seats in a way that optimizes the capacity.
+ * Places the reservations on the seats in a way that optimizes the capacity,
+ * using the sparsest distribution strategy (OPTIMIZE_SPARSEST).
  *
  * @param res_arr[] The logical representation of each reservation.
  * @param res_arr_count The number of reservations in the res_array.
@@ -98,4 +168,172 @@ SeatCollection* optimize_reservation(unsigned int res_arr[], int res_arr_count,
                                      int res_ids[], int segment_count,
                                      int seat_ids[], int seat_count);
 
+/**
+ * @brief Get a registered optimization strategy.
+ *
+ * @param strategy The strategy identifier.
+ * @return Returns the registry entry or NULL if the strategy is unknown.
+ */
+const OptimizeStrategyInfo* get_optimize_strategy(OptimizeStrategy strategy);
+
+/**
+ * @brief Get a registered optimization strategy by its name.
+ *
+ * @param name The name of the strategy ("sparsest", "compact" or
+ * "group-adjacent").
+ * @return Returns the registry entry or NULL if no strategy has this name.
+ */
+const OptimizeStrategyInfo* get_optimize_strategy_by_name(const char* name);
+
+/**
+ * @brief Optimize the reservations with a given strategy
+ *
+ * Places the reservations on the seats according to the selected strategy.
+ * Consecutive entries with the same reservation id are treated as one group
+ * reservation. Every reservation that could be placed is set to 0 in the
+ * res_arr, so remaining non-zero entries did not fit on any seat.
+ *
+ * @param strategy The optimization strategy.
+ * @param res_arr[] The logical representation of each reservation.
+ * @param res_arr_count The number of reservations in the res_array.
+ * @param res_ids[] Array that contains the reservation ids
+ * @param segment_count The number of segments on the route (max. 32).
+ * @param seat_ids[] Array that contains the seat ids
+ * @param seat_count The number of seats in the composition.
+ * @return Returns a pointer of the optimized Seat_collection or NULL on
+ * invalid parameters.
+ */
+SeatCollection* optimize_reservation_with(OptimizeStrategy strategy,
+                                          unsigned int res_arr[],
+                                          int res_arr_count, int res_ids[],
+                                          int segment_count, int seat_ids[],
+                                          int seat_count);
+
+/**
+ * @brief Optimize the reservations of long routes with a given strategy
+ *
+ * Same as optimize_reservation_with(), but with 64 bit segment masks for
+ * routes with up to 64 segments.
+ *
+ * @param strategy The optimization strategy.
+ * @param res_arr[] The logical representation of each reservation.
+ * @param res_arr_count The number of reservations in the res_array.
+ * @param res_ids[] Array that contains the reservation ids
+ * @param segment_count The number of segments on the route (max. 64).
+ * @param seat_ids[] Array that contains the seat ids
+ * @param seat_count The number of seats in the composition.
+ * @return Returns a pointer of the optimized Seat_collection or NULL on
+ * invalid parameters.
+ */
+SeatCollection* optimize_reservation_wide(OptimizeStrategy strategy,
+                                          unsigned long long res_arr[],
+                                          int res_arr_count, int res_ids[],
+                                          int segment_count, int seat_ids[],
+                                          int seat_count);
+
+/**
+ * @brief Create a new optimization workspace.
+ *
+ * The workspace starts without buffers, they grow on demand and are reused by
+ * later calls.
+ *
+ * @return Returns a pointer to the new workspace.
+ */
+OptimizeWorkspace* new_optimize_workspace();
+
+/**
+ * @brief Reserve the buffers of a workspace.
+ *
+ * Grows the buffers to hold at least the given numbers of elements. Calling
+ * it up front with the largest trip avoids any allocation later.
+ *
+ * @param workspace The workspace.
+ * @param res_count The number of reservations of a trip.
+ * @param seat_res_count The number of reserved seats.
+ * @param seat_count The number of seats.
+ */
+void optimize_workspace_reserve(OptimizeWorkspace* workspace, int res_count,
+                                int seat_res_count, int seat_count);
+
+/**
+ * @brief Optimize the reservations into a workspace
+ *
+ * Same as optimize_reservation_with(), but uses the buffers of the workspace
+ * and writes the result into the output collection of the workspace. Once
+ * the buffers are large enough, no memory is allocated. Routes up to 32
+ * segments run on the narrow kernels.
+ *
+ * @note The returned collection is owned by the workspace and only valid
+ * until the next call with the same workspace. Do not delete it, use
+ * optimize_workspace_detach() to keep it.
+ *
+ * @param workspace The workspace.
+ * @param strategy The optimization strategy.
+ * @param res_arr[] The logical representation of each reservation; placed
+ * reservations are set to 0.
+ * @param res_arr_count The number of reservations in the res_array.
+ * @param res_ids[] Array that contains the reservation ids
+ * @param segment_count The number of segments on the route (max. 64).
+ * @param seat_ids[] Array that contains the seat ids
+ * @param seat_count The number of seats in the composition.
+ * @return Returns a pointer to the collection of the workspace or NULL on
+ * invalid parameters.
+ */
+SeatCollection* optimize_reservation_in(OptimizeWorkspace* workspace,
+                                        OptimizeStrategy strategy,
+                                        unsigned long long res_arr[],
+                                        int res_arr_count, int res_ids[],
+                                        int segment_count, int seat_ids[],
+                                        int seat_count);
+
+/**
+ * @brief Take the output collection from a workspace.
+ *
+ * The caller owns the collection and has to delete it with
+ * delete_seat_collection(). The next optimization with the workspace creates
+ * a new output collection.
+ *
+ * @param workspace The workspace.
+ * @return Returns the output collection or NULL if there is none.
+ */
+SeatCollection* optimize_workspace_detach(OptimizeWorkspace* workspace);
+
+/**
+ * @brief Delete an optimization workspace.
+ *
+ * Frees the buffers and the output collection of the workspace.
+ *
+ * @param workspace The workspace to delete.
+ */
+void delete_optimize_workspace(OptimizeWorkspace* workspace);
+
+/**
+ * @brief Optimize the reservations within a time budget
+ *
+ * Anytime solver for group reservations. Starts from the group-adjacent greedy
+ * solution and improves it by local search over the order in which the groups
+ * are placed, until no group is split, or the deadline is reached. Returns the
+ * best solution found. Reserved seats that do not fit on a single seat along
+ * their whole trip are finally distributed over several seats (seat changes).
+ * The deadline and the quality metrics are reported in the quality field of
+ * the collection.
+ *
+ * @param res_arr[] The logical representation of each reservation (not
+ * modified).
+ * @param res_arr_count The number of reservations in the res_array.
+ * @param res_ids[] Array that contains the reservation ids, consecutive equal
+ * ids form a group.
+ * @param segment_count The number of segments on the route (max. 64).
+ * @param seat_ids[] Array that contains the seat ids
+ * @param seat_count The number of seats in the composition.
+ * @param deadline_us The time budget in microseconds, 0 only runs the greedy
+ * construction.
+ * @return Returns a pointer of the optimized Seat_collection or NULL on
+ * invalid parameters.
+ */
+SeatCollection* optimize_reservation_anytime(unsigned long long res_arr[],
+                                             int res_arr_count, int res_ids[],
+                                             int segment_count, int seat_ids[],
+                                             int seat_count, long deadline_us);
+
 #endif  // OSURS_OPTIMIZE_H_
\ No newline at end of file
@@ -40,6 +40,74 @@
  */
 Connection *new_connection(const Node *orig, const Node *dest, int time);
 
+/**
+ * @brief Create connection between nodes on a service date.
+ *
+ * Same as new_connection(), but only on trips running on the date (see
+ * trip_runs_on()) and with the seats available on the date. Reservations of
+ * the connections are booked on the service day of the trip, which is
+ * allocated on the first booking of the date.
+ *
+ * @param orig Origin node in network for connection.
+ * @param dest Destination node in network for connection.
+ * @param time The departure time in seconds after midnight (00:00:00).
+ * @param date The service date, -1 for the undated occupancy of the trips
+ * (same as new_connection()).
+ * @return Returns a pointer to a connection chain or NULL if no connection was
+ * found.
+ */
+Connection *new_connection_on(const Node *orig, const Node *dest, int time,
+                              int date);
+
+/**
+ * @brief Create connection between nodes given by their index.
+ *
+ * Same as new_connection(), but the nodes are given by their dense index in
+ * the network (Node.index) instead of pointers.
+ *
+ * @param network The network.
+ * @param orig Index of the origin node.
+ * @param dest Index of the destination node.
+ * @param time The departure time in seconds after midnight (00:00:00).
+ * @return Returns a pointer to a connection chain or NULL if no connection was
+ * found or an index is out of range.
+ */
+Connection *new_connection_at(Network *network, int orig, int dest, int time);
+
+/**
+ * @brief Create connection between nodes on a frozen network.
+ *
+ * Same search as new_connection(), but on the contiguous arrays of a frozen
+ * network (see freeze_network()). Returns the same connection chain, which can
+ * be checked, selected and reserved like the results of new_connection().
+ *
+ * @param frozen The frozen network.
+ * @param orig Origin node in network for connection.
+ * @param dest Destination node in network for connection.
+ * @param time The departure time in seconds after midnight (00:00:00).
+ * @return Returns a pointer to a connection chain or NULL if no connection was
+ * found.
+ *
+ * @note The frozen search is undated and reads the occupancy of the trips,
+ * see new_connection_on() for service dates.
+ */
+Connection *frozen_new_connection(FrozenNetwork *frozen, const Node *orig,
+                                  const Node *dest, int time);
+
+/**
+ * @brief Create connection between nodes given by their index on a frozen
+ * network.
+ *
+ * @param frozen The frozen network.
+ * @param orig Index of the origin node (Node.index).
+ * @param dest Index of the destination node (Node.index).
+ * @param time The departure time in seconds after midnight (00:00:00).
+ * @return Returns a pointer to a connection chain or NULL if no connection was
+ * found or an index is out of range.
+ */
+Connection *frozen_new_connection_at(FrozenNetwork *frozen, int orig, int dest,
+                                     int time);
+
 /**
  * @brief Check if seats are available in connection.
  *
@@ -85,7 +153,11 @@ Connection *select_connection(Connection *connection, int seats);
  * Books a connection on the network, if the desired seats are available. If
  * enough seats are available the reservation counts of the corresponding trip
  * on the stops of the routes are increased and a new reservation is allocated
- * and connected to the network.
+ * and connected to the network. Dated connections (see new_connection_on())
+ * are booked on the service day of the trip.
+ *
+ * @note The check and the booking hold the lock of the network, so bookings
+ * are serialized with each other and with network_snapshot().
  *
  * @param connection The connection to reserve.
  * @param seats The number of seats to reserve.
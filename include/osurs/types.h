@@ -12,7 +12,9 @@
 #define OSURS_TYPES_H_
 
 #include <osurs/ds.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <time.h>
 
 #define MINUTES 60
 #define HOURS 3600
@@ -27,6 +29,8 @@ struct composition_t;
 struct connection_t;
 struct reservation_t;
 struct network_t;
+struct calendar_t;
+struct service_day_t;
 struct seat_t;
 struct seat_collection_t;
 
@@ -36,10 +40,14 @@ struct seat_collection_t;
  * A node is a stop location used by different routes.
  */
 typedef struct node_t {
-    char *id;        /**< Identifier. */
-    double x;        /**< X coordinate. */
-    double y;        /**< Y coordinate. */
-    HashMap *routes; /**< HashMap with routes passing the node. */
+    const char *id;          /**< Identifier. */
+    int index;               /**< Dense index in the network. */
+    double x;                /**< X coordinate. */
+    double y;                /**< Y coordinate. */
+    int *route_indices;      /**< Sorted indices of the routes passing. */
+    struct route_t **routes; /**< Routes passing, ordered by index. */
+    int route_count;         /**< Number of routes passing the node. */
+    int route_capacity;      /**< Capacity of the route arrays. */
 } Node;
 
 /**
@@ -51,10 +59,14 @@ typedef struct node_t {
  */
 typedef struct stop_t {
     int time_to_next;     /**< Identifier. */
+    int ordinal;          /**< Position on the route, 0 for the root stop. */
+    int index;            /**< Dense index in the network. */
     int arrival_offset;   /**< The offset from the root stop arrival. */
     int departure_offset; /**< The offset from the root stop departure. */
     int *reserved; /**< Array with the number of reservations on the stop for
                       each trip. */
+    unsigned long reserved_epoch; /**< Snapshot epoch in which the reserved
+                                     array was copied, 0 for the original. */
     struct node_t *node; /**< The corresponding node in the network. */
     struct stop_t *prev; /**< The previous stop on the route. */
     struct stop_t *next; /**< The next stop on the route. */
@@ -69,18 +81,71 @@ typedef struct stop_t {
  * reservations are stored at the trip level.
  */
 typedef struct trip_t {
-    char *id;      /**< Identifier. */
+    const char *id; /**< Identifier. */
     int departure; /**< Departure time in seconds after midnight of the trip at
                       the first stop of the route. */
     int arrival; /**< Arrival time in seconds after midnight of the trip at the
                     last stop of the route. */
+    int ordinal; /**< Position on the route, 0 for the root trip. */
+    int index;   /**< Dense index in the network. */
     struct vehicle_t *vehicle; /**< The vehicle used to travel along the route
                                   with this trip / departure. */
     struct trip_t *next;   /**< The next trip starting after the current one. */
     struct route_t *route; /**< The route the trip corresponds to. */
     ArrayList *reservations; /**< Reservation in the network. */
+    unsigned long reservations_epoch; /**< Snapshot epoch in which the
+                                         reservation array was copied. */
+    unsigned int version; /**< Incremented on every change of the
+                             reservations. */
+    struct seat_collection_t *cache; /**< Cached optimization result (see
+                                        optimize_trip_cached()). */
+    unsigned int cache_version; /**< Trip version of the cached result. */
+    int cache_strategy; /**< Strategy of the cached result, -1 if empty. */
+    struct calendar_t *calendar; /**< Service days of the trip, NULL if the
+                                    trip runs every day. */
+    struct service_day_t **service_days; /**< Booked service days, sorted by
+                                            date (see new_service_day()). */
+    int service_day_count;    /**< Number of booked service days. */
+    int service_day_capacity; /**< Capacity of the service day array. */
+    unsigned long service_days_epoch; /**< Snapshot epoch in which the
+                                         service day array was copied. */
 } Trip;
 
+/**
+ * @brief A service calendar.
+ *
+ * A bitmap of the dates on which the trips referencing the calendar run.
+ * Dates are day numbers in a unit chosen by the application (e.g. days since
+ * 1970-01-01), the bitmap covers the dates first_day to first_day +
+ * day_count - 1.
+ */
+typedef struct calendar_t {
+    const char *id;           /**< Identifier. */
+    int first_day;            /**< First date of the bitmap. */
+    int day_count;            /**< Number of dates of the bitmap. */
+    unsigned long long *days; /**< Bit d is set if the date first_day + d is
+                                 a service day. */
+} Calendar;
+
+/**
+ * @brief A service day of a trip.
+ *
+ * The reservations of a trip on a date. Allocated on the first booking of the
+ * trip on the date, so dates without bookings use no memory.
+ */
+typedef struct service_day_t {
+    int date;              /**< The date of the service day. */
+    int index;             /**< Dense index in the network. */
+    struct trip_t *trip;   /**< The trip. */
+    int *reserved;         /**< Number of reservations on each stop of the
+                              route, indexed by the stop ordinal. */
+    unsigned long reserved_epoch; /**< Snapshot epoch in which the reserved
+                                     array was copied, 0 for the original. */
+    ArrayList *reservations;      /**< Reservations on the date. */
+    unsigned long reservations_epoch; /**< Snapshot epoch in which the
+                                         reservation array was copied. */
+} ServiceDay;
+
 /**
  * @brief A route.
  *
@@ -89,13 +154,17 @@ typedef struct trip_t {
  * approached by a vehicle in a chain of stops.
  */
 typedef struct route_t {
-    char *id; /**< Identifier. */
+    const char *id; /**< Identifier. */
+    int index;      /**< Dense index in the network. */
     struct stop_t
         *root_stop; /**< The first stop (head) of the chain of stops. */
     struct trip_t
         *root_trip; /**< The first trip (head) of the linked list of trips. */
     size_t route_size; /**< Number of stops in the route. */
     size_t trip_size;  /**< Number of trips on the route. */
+    struct trip_t **trip_index; /**< Trips sorted by identifier and ordinal
+                                   (see get_trip()). */
+    struct network_t *network;  /**< The network of the route. */
 } Route;
 
 /**
@@ -104,7 +173,8 @@ typedef struct route_t {
  * A vehicle consists of an identifier and vehicle composition.
  */
 typedef struct vehicle_t {
-    char *id;                          /**< Identifier. */
+    const char *id;                    /**< Identifier. */
+    int index;                         /**< Dense index in the network. */
     struct composition_t *composition; /**< The composition of the vehicle. */
 } Vehicle;
 
@@ -115,12 +185,26 @@ typedef struct vehicle_t {
  * seat capacity.
  */
 typedef struct composition_t {
-    char *id;       /**< Identifier. */
+    const char *id; /**< Identifier. */
     int seat_count; /**< The seat capacity of the composition (TODO: Replace
                   with groups in future). */
     int *seat_ids;  /**< The seat id array */
 } Composition;
 
+/**
+ * @brief Operations on the cached optimization results of the trips.
+ *
+ * Set by the optimization layer when it caches a result on a trip (see
+ * optimize_trip_cached()), so that the network releases and measures the
+ * cached seat collections without depending on the optimization.
+ */
+typedef struct trip_cache_ops_t {
+    void (*free)(
+        struct seat_collection_t *collection); /**< Delete a result. */
+    size_t (*memory)(const struct seat_collection_t
+                         *collection); /**< Bytes allocated by a result. */
+} TripCacheOps;
+
 /**
  * @brief A network.
  *
@@ -128,12 +212,175 @@ typedef struct composition_t {
  * and off.
  */
 typedef struct network_t {
-    HashMap *nodes;        /**< Nodes in the network. */
-    HashMap *routes;       /**< Routes in the network. */
-    HashMap *vehicles;     /**< Vehicles in the network. */
-    HashMap *compositions; /**< Compositions in the network. */
+    HashMap *nodes;          /**< Nodes in the network. */
+    HashMap *routes;         /**< Routes in the network. */
+    HashMap *vehicles;       /**< Vehicles in the network. */
+    HashMap *compositions;   /**< Compositions in the network. */
+    StringPool *ids;         /**< Interned identifiers of the network. */
+    Arena *arena;            /**< Memory of the structure of the network. */
+    ArrayList *node_list;    /**< Nodes by their dense index. */
+    ArrayList *route_list;   /**< Routes by their dense index. */
+    ArrayList *trip_list;    /**< Trips by their dense index. */
+    ArrayList *vehicle_list; /**< Vehicles by their dense index. */
+    HashMap *calendars;      /**< Service calendars of the trips. */
+    ArrayList *service_day_list; /**< Booked service days by their dense
+                                    index. */
+    int stop_count;          /**< Number of stops of all routes. */
+    unsigned long epoch;     /**< Epoch of the latest snapshot. */
+    ArrayList *snapshots;    /**< Live snapshots (see network_snapshot()). */
+    ArrayList *retired;      /**< Reserved arrays replaced while shared. */
+    pthread_mutex_t lock;    /**< Serializes bookings and taking and deleting
+                                snapshots. */
+    const TripCacheOps *cache_ops; /**< Operations on the cached results of
+                                      the trips, NULL if none is cached. */
+    ArrayList *frozen_views; /**< Live frozen views of the network, updated
+                                by the bookings (see freeze_network()). */
 } Network;
 
+/**
+ * @brief A retired array.
+ *
+ * A reserved array of a stop or service day, or a reservation or service day
+ * array of a trip or service day, replaced by a booking while a snapshot
+ * shared it, kept until no snapshot shares it anymore.
+ */
+typedef struct retired_page_t {
+    void *page;          /**< The replaced array. */
+    size_t size;         /**< Size of the array in bytes. */
+    int in_arena;        /**< Non-zero if the array is located in the arena. */
+    unsigned long epoch; /**< Epoch in which the array was created. */
+    unsigned long until; /**< Latest snapshot epoch sharing the array. */
+} RetiredPage;
+
+/**
+ * @brief A list shared with a snapshot.
+ *
+ * The elements array of a list at the time of a snapshot with its length
+ * then; bookings only append behind the length or copy the array.
+ */
+typedef struct snapshot_list_t {
+    void **elements; /**< The shared elements array. */
+    size_t size;     /**< Number of elements at the time of the snapshot. */
+} SnapshotList;
+
+/**
+ * @brief A snapshot of a network.
+ *
+ * Consistent read-only view of the reservations of a network at the time of
+ * the snapshot (see network_snapshot()). The structure of the network is
+ * shared, the reserved arrays of the stops are shared until a booking writes
+ * to them (copy-on-write). The lists of reservations and service days are
+ * shared with their length, bookings copy them instead of moving them.
+ */
+typedef struct network_snapshot_t {
+    struct network_t *network;  /**< The network of the snapshot. */
+    unsigned long epoch;        /**< Epoch of the snapshot. */
+    int stop_count;             /**< Number of stops. */
+    int **reserved;             /**< Reserved array of each stop index. */
+    int trip_count;             /**< Number of trips. */
+    SnapshotList *reservations; /**< Reservations of each trip index. */
+    SnapshotList *service_days; /**< Service days of each trip index. */
+    int service_day_count;      /**< Number of booked service days. */
+    int **service_day_reserved; /**< Reserved array of each service day. */
+    SnapshotList *day_reservations; /**< Reservations of each service day. */
+} NetworkSnapshot;
+
+/**
+ * @brief Memory usage of a category of objects.
+ */
+typedef struct memory_usage_t {
+    size_t count; /**< Number of objects. */
+    size_t bytes; /**< Number of bytes allocated for the objects. */
+} MemoryUsage;
+
+/**
+ * @brief Memory usage of a network.
+ *
+ * Bytes requested by the library from the arena and the heap, computed from
+ * the sizes of its own allocations (see network_memory_stats()). The overhead
+ * of the C library allocator is not included.
+ */
+typedef struct network_memory_stats_t {
+    MemoryUsage nodes;        /**< Nodes. */
+    MemoryUsage node_routes;  /**< Route arrays of the nodes (per route). */
+    MemoryUsage routes;       /**< Routes and their trip indices. */
+    MemoryUsage stops;        /**< Stops. */
+    MemoryUsage occupancy;    /**< Reserved arrays of the stops and service
+                                 days (also the copies of snapshots, counted
+                                 once). */
+    MemoryUsage trips;        /**< Trips. */
+    MemoryUsage calendars;    /**< Service calendars and their bitmaps. */
+    MemoryUsage service_days; /**< Booked service days of the trips. */
+    MemoryUsage reservations; /**< Reservations and the lists of the trips. */
+    MemoryUsage vehicles;     /**< Vehicles. */
+    MemoryUsage compositions; /**< Compositions and their seat ids. */
+    MemoryUsage ids;          /**< Interned identifiers (pool blocks). */
+    MemoryUsage hash_maps;    /**< Hashmaps (per entry), dense lists and the
+                                 service day arrays of the trips. */
+    MemoryUsage seat_collections; /**< Cached optimization results. */
+    MemoryUsage snapshots;        /**< Live snapshots. */
+    size_t arena_reserved;        /**< Bytes of all arena blocks. */
+    size_t arena_allocated;       /**< Bytes handed out by the arena. */
+    size_t total; /**< Bytes of all categories plus unused arena bytes. */
+} NetworkMemoryStats;
+
+/**
+ * @brief A frozen network.
+ *
+ * Immutable struct-of-arrays view of a network for query hot paths, compiled
+ * by freeze_network(). Nodes, routes and trips are identified by their dense
+ * network index, stops by their position in the contiguous stop arrays; the
+ * stops and trips of a route and the routes of a node are stored as ranges
+ * (start[i] to start[i + 1]).
+ * The reservation counts of each trip are copied into a contiguous block of
+ * the view, which the bookings update together with the network.
+ */
+typedef struct frozen_network_t {
+    struct network_t *network; /**< The network the view was compiled from. */
+    int node_count;            /**< Number of nodes. */
+    struct node_t **nodes;     /**< Node of each node index. */
+    int *node_route_start;     /**< First entry of each node in node_routes. */
+    int *node_routes;          /**< Routes passing each node. */
+    int route_count;                 /**< Number of routes. */
+    struct route_t **routes;         /**< Route of each route index. */
+    int *route_stop_start;           /**< First stop index of each route. */
+    int *route_trip_start;           /**< First trip index of each route. */
+    int stop_count;                  /**< Number of stops of all routes. */
+    int *stop_nodes;                 /**< Node index of each stop. */
+    int *stop_arrival_offsets;       /**< Arrival offset of each stop. */
+    int *stop_departure_offsets;     /**< Departure offset of each stop. */
+    struct stop_t **stops;           /**< Stop of each stop index. */
+    int trip_count;                  /**< Number of trips of all routes. */
+    int *trip_departures;            /**< Departure of each trip. */
+    int *trip_arrivals;              /**< Arrival of each trip. */
+    int *trip_capacities;            /**< Seat capacity of each trip. */
+    struct trip_t **trips;           /**< Trip of each trip index. */
+    int *trip_reserved_start; /**< First entry of each trip in
+                                 trip_reserved. */
+    int *trip_reserved; /**< Reservation counts of each trip on the stops of
+                           its route, contiguous per trip. */
+} FrozenNetwork;
+
+/**
+ * @brief A network partitioned by route.
+ *
+ * Each shard is an independent network with a subset of the routes of the
+ * source network, the nodes, vehicles, compositions and calendars they use
+ * and their reservations (see shard_network()). Nodes passed by routes of
+ * several shards are part of each of these shards. The routing table maps the
+ * nodes of the source network to the shards serving them as ranges
+ * (node_shard_start[i] to node_shard_start[i + 1]).
+ */
+typedef struct network_shards_t {
+    struct network_t *network;  /**< The source network. */
+    int shard_count;            /**< Number of shards. */
+    struct network_t **shards;  /**< Network of each shard. */
+    int *route_shards;          /**< Shard of each route index. */
+    int node_count;             /**< Number of nodes of the source network. */
+    int *node_shard_start;      /**< First entry of each node in node_shards. */
+    int *node_shards;           /**< Sorted shards serving each node. */
+} NetworkShards;
+
 /**
  * @brief A connection.
  *
@@ -143,6 +390,8 @@ typedef struct connection_t {
     int departure;       /**< Departure time in seconds. */
     int arrival;         /**< Arrival time in seconds. */
     int available;       /**< Available seats (capacity - reserved). */
+    int date;            /**< Service date, -1 for the undated occupancy of
+                            the trip. */
     struct stop_t *orig; /**< Origin stop. */
     struct stop_t *dest; /**< Destination stop. */
     struct trip_t
@@ -164,6 +413,7 @@ typedef struct reservation_t {
     char id[37]; /**< Automatically generated UUID of the reservation. */
     int res_id;  /**< Reservation id. */
     int seats;   /**< Reserved seats. */
+    int date;    /**< Service date, -1 if booked on the undated trip. */
     struct stop_t *orig; /**< The orig stop of the reservation. */
     struct stop_t *dest; /**< The orig stop of the reservation. */
     struct trip_t *trip; /**< The trip on which the reservation is placed. */
@@ -176,11 +426,43 @@ typedef struct reservation_t {
  * A seat contains an array of reservations.
  */
 typedef struct seat_t {
-    int seat_id;     /**< Seat id. */
-    int res_count;   /**< Number of reservations. */
-    int *res_id_arr; /**< Array that contains each reservation id. */
+    int seat_id;      /**< Seat id. */
+    int res_count;    /**< Number of reservations. */
+    int res_capacity; /**< Allocated length of the reservation id array. */
+    int *res_id_arr;  /**< Array that contains each reservation id. */
 } Seat;
 
+/**
+ * @brief Quality of an optimization
+ *
+ * Metrics of a seat distribution, set by the anytime solver
+ * (optimize_reservation_anytime()). All values are 0 for the other strategies.
+ */
+typedef struct optimize_quality_t {
+    long deadline_us;   /**< Time budget of the solver in microseconds. */
+    long elapsed_us;    /**< Time used by the solver in microseconds. */
+    int iterations;     /**< Number of improvement steps tried. */
+    int groups_split;   /**< Group reservations not seated side by side. */
+    int seat_changes;   /**< Seat changes of passengers along their trip. */
+    int unplaced;       /**< Reserved seats which could not be placed. */
+    double seat_changes_per_passenger; /**< Seat changes per reserved seat. */
+} OptimizeQuality;
+
+/**
+ * @brief A reverse index of a seat collection
+ *
+ * Maps each reservation id to the ids of the seats it is placed on, using an
+ * open addressing hash table over the reservation ids.
+ */
+typedef struct seat_index_t {
+    int *res_ids;  /**< Reservation id of each slot, -1 if the slot is empty. */
+    int *start;    /**< First seat id of each slot in the seat id array. */
+    int *count;    /**< Number of seat ids of each slot. */
+    int capacity;  /**< Number of slots (power of two). */
+    int *seat_ids; /**< Seat ids grouped by reservation. */
+    int seat_capacity; /**< Capacity of the seat id array. */
+} SeatIndex;
+
 /**
  * @brief A seat collection
  *
@@ -190,6 +472,145 @@ typedef struct seat_t {
 typedef struct seat_collection_t {
     Seat **seat_arr; /**< Array that contains all the available seats. */
     int seat_count;  /**< Number of seats in the collection. */
+    int seat_capacity; /**< Allocated length of seat_arr and segments. */
+    unsigned long long *segments; /**< Reserved segments (bit mask) of each
+                                     seat, stored contiguously for free seat
+                                     queries (see find_free_seats()). */
+    int res_covered; /**< Number of trip reservations distributed, set when
+                        optimized on a trip (see reoptimize_trip()). */
+    const ArrayList *res_source; /**< Reservations of the trip or service day
+                                    the collection was optimized from, NULL
+                                    if not optimized on a trip. */
+    OptimizeQuality quality; /**< Quality metrics of the distribution. */
+    SeatIndex *index; /**< Reverse index from reservations to seats, built by
+                         the optimizations (see seat_collection_find()). */
 } SeatCollection;
 
+/**
+ * @brief The optimization of all trips in a network.
+ *
+ * Flat result arrays of a whole network optimization; the seat collection at
+ * index i belongs to the trip at index i.
+ */
+typedef struct network_optimization_t {
+    struct trip_t **trips; /**< Array with the optimized trips. */
+    struct seat_collection_t *
+        *collections; /**< Array with the seat collection of each trip or NULL
+                         if the trip has no reservations. */
+    size_t size;      /**< Number of optimized trips. */
+    int threads;      /**< Number of threads used for the optimization. */
+} NetworkOptimization;
+
+/**
+ * @brief An optimization strategy.
+ *
+ * Selects the rule by which reservations are distributed among the seats of a
+ * trip.
+ */
+typedef enum optimize_strategy_t {
+    OPTIMIZE_SPARSEST = 0, /**< Fill seat after seat with as many
+                              non-overlapping reservations as possible. */
+    OPTIMIZE_COMPACT,      /**< Place the reservations ordered by origin on the
+                              first seat that is free along their segments,
+                              which needs the least number of seats. */
+    OPTIMIZE_GROUP_ADJACENT, /**< Like compact, but place the seats of a group
+                                reservation side by side if possible. */
+    OPTIMIZE_STRATEGY_COUNT  /**< Number of available strategies. */
+} OptimizeStrategy;
+
+/**
+ * @brief A reusable optimization workspace.
+ *
+ * Owns growable buffers and an output seat collection which are reused across
+ * optimizations, so that repeated optimizations do not allocate once the
+ * buffers are large enough. A workspace must only be used by one thread at a
+ * time; create one per thread.
+ */
+typedef struct optimize_workspace_t {
+    unsigned long long *trip_masks; /**< Segment mask of each reservation. */
+    int trip_capacity;              /**< Length of the trip mask array. */
+    unsigned long long *masks;      /**< Segment mask of each reserved seat. */
+    unsigned int *narrow_masks; /**< 32 bit copy of the masks for the narrow
+                                   kernels. */
+    int *res_ids;               /**< Reservation id of each reserved seat. */
+    int *index;                 /**< Kernel scratch array. */
+    int *order;                 /**< Kernel scratch array. */
+    int capacity; /**< Length of the reserved seat arrays. */
+    unsigned long long *seat_config; /**< Reserved segments of each seat. */
+    int seat_capacity;               /**< Length of the seat config array. */
+    struct seat_collection_t *collection; /**< The output collection. */
+    int collection_capacity; /**< Allocated seats of the output collection. */
+} OptimizeWorkspace;
+
+/**
+ * @brief A registered optimization strategy.
+ *
+ * All strategies are specialized for 32 bit (narrow) and 64 bit (wide)
+ * segment masks. The kernels place the reservations on the seats of an empty
+ * collection, using the scratch buffers of a workspace which has been
+ * reserved for the number of reserved seats and seats (see
+ * optimize_workspace_reserve()).
+ */
+typedef struct optimize_strategy_info_t {
+    const char *name;          /**< Name of the strategy. */
+    OptimizeStrategy strategy; /**< Strategy identifier. */
+    /** Kernel for routes up to 32 segments. */
+    void (*optimize)(OptimizeWorkspace *workspace, unsigned int res_arr[],
+                     int res_arr_count, int res_ids[], int segment_count,
+                     struct seat_collection_t *collection);
+    /** Kernel for routes up to 64 segments. */
+    void (*optimize_wide)(OptimizeWorkspace *workspace,
+                          unsigned long long res_arr[], int res_arr_count,
+                          int res_ids[], int segment_count,
+                          struct seat_collection_t *collection);
+} OptimizeStrategyInfo;
+
+/**
+ * @brief A clock of the optimization scheduler.
+ *
+ * Provides the current time and a way to wait, so that the scheduler can run
+ * on the wall clock or on a simulated time.
+ */
+typedef struct scheduler_clock_t {
+    int (*now)(void *context); /**< Current time in seconds after midnight of
+                                  the service day, beyond 24 hours after
+                                  midnight. */
+    void (*sleep)(void *context,
+                  int seconds); /**< Wait for the given number of seconds. */
+    void *context;              /**< Context passed to the clock functions. */
+} SchedulerClock;
+
+/**
+ * @brief Callback of the optimization scheduler.
+ *
+ * Called on the thread running the scheduler for every optimized trip, in
+ * the order of the departures. The callback owns the seat collection (NULL if
+ * the trip has no reservations) and has to delete it.
+ */
+typedef void (*SchedulerCallback)(struct trip_t *trip,
+                                  struct seat_collection_t *collection,
+                                  void *context);
+
+/**
+ * @brief A departure-driven optimization scheduler.
+ *
+ * Orders the trips of a network by the time they are due for optimization,
+ * which is the departure at the root stop minus a lead time, and optimizes
+ * them when they are due on a worker pool.
+ */
+typedef struct scheduler_t {
+    PriorityQueue *queue;      /**< Trips ordered by their due time. */
+    int lead_time;             /**< Seconds before the departure. */
+    OptimizeStrategy strategy; /**< The optimization strategy. */
+    int threads;               /**< Number of worker threads. */
+    struct pool_t *pool;       /**< Worker threads, kept for the lifetime. */
+    OptimizeWorkspace **workspaces; /**< One workspace per worker. */
+    time_t midnight; /**< Wall clock time of the midnight the due times
+                        refer to. */
+    SchedulerClock clock;           /**< The clock of the scheduler. */
+    SchedulerCallback callback;     /**< Receiver of the optimized trips. */
+    void *callback_context; /**< Context passed to the callback. */
+    size_t optimized;       /**< Number of trips optimized so far. */
+} Scheduler;
+
 #endif  // OSURS_TYPES_H_
@@ -0,0 +1,98 @@
+/**
+ * @brief Arena data structure
+ * @file arena.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include "osurs/ds/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The alignment of all allocations. */
+#define ALIGNMENT 16
+
+/** The number of bytes of the first block. */
+#define INIT_BLOCK_CAPACITY 4096
+
+/** The maximal number of bytes of a block (except for larger allocations). */
+#define MAX_BLOCK_CAPACITY (1 << 20)
+
+/** The offset of the memory of a block after the header. */
+#define HEADER_SIZE \
+    ((sizeof(ArenaBlock) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+
+// private declarations
+
+static void arena_grow(Arena* arena, size_t size);
+
+// public implementations
+
+Arena* arena_create() {
+    Arena* arena = malloc(sizeof(Arena));
+    if (arena == NULL) {
+        perror("Error allocating memory for arena");
+        exit(1);
+    }
+    arena->blocks = NULL;
+    arena->block_count = 0;
+    arena->allocated = 0;
+    arena->reserved = 0;
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = arena_alloc_size(size);
+    ArenaBlock* block = arena->blocks;
+    if (block == NULL || block->capacity - block->used < size) {
+        arena_grow(arena, size);
+        block = arena->blocks;
+    }
+    void* data = (char*)block + HEADER_SIZE + block->used;
+    block->used += size;
+    arena->allocated += size;
+    return data;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    void* data = arena_alloc(arena, count * size);
+    memset(data, 0, count * size);
+    return data;
+}
+
+size_t arena_alloc_size(size_t size) {
+    if (size == 0) return ALIGNMENT;
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void arena_free(Arena* arena) {
+    ArenaBlock* block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+// private implementations
+
+static void arena_grow(Arena* arena, size_t size) {
+    size_t capacity = arena->blocks == NULL ? INIT_BLOCK_CAPACITY
+                                            : arena->blocks->capacity * 2;
+    if (capacity > MAX_BLOCK_CAPACITY) capacity = MAX_BLOCK_CAPACITY;
+    if (capacity < size) capacity = size;
+    ArenaBlock* block = malloc(HEADER_SIZE + capacity);
+    if (block == NULL) {
+        perror("Error allocating memory for arena block");
+        exit(1);
+    }
+    block->capacity = capacity;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->block_count++;
+    arena->reserved += capacity;
+}
@@ -11,16 +11,59 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 /** The load factor to trigger resizing of the hashmap capacity. */
 #define LOAD_FACTOR 0.75
 
+/** The load factor to trigger shrinking of the hashmap capacity. */
+#define SHRINK_FACTOR 0.125
+
 /** The initial hashmap capacity. */
 #define INIT_CAPACITY 10
 
+/** The number of control bytes probed at once (open addressing). */
+#define GROUP_WIDTH 16
+
+/** Control byte of a slot which has never been used. */
+#define CTRL_EMPTY 0x80
+
+/** Control byte of a slot whose entry was removed (tombstone). */
+#define CTRL_DELETED 0xFE
+
+/** Constants of the string hash (wyhash secrets). */
+#define HASH_SEED 0xA0761D6478BD642Full
+#define HASH_WORD 0xE7037ED1A0B428DBull
+#define HASH_FINAL 0x8EBC6AF09C88C6E3ull
+
 // private declarations
 
-static unsigned int hash(const char* key, int capacity);
-static void hash_map_resize(HashMap* map, int new_capacity);
+static unsigned long long mix(unsigned long long a, unsigned long long b);
+static unsigned long long hash_string(const char* key);
+static unsigned long long next_random(unsigned long long* state);
+static size_t chained_capacity(size_t count);
+static size_t open_capacity(size_t count);
+static void hash_map_resize(HashMap* map, size_t new_capacity);
+static void dense_alloc(HashMap* map);
+static unsigned int group_match(const unsigned char* group,
+                                unsigned char byte);
+static unsigned int group_match_free(const unsigned char* group);
+static int lowest_bit(unsigned int bits);
+static void set_control(HashMap* map, size_t slot, unsigned char byte);
+static size_t open_find(const HashMap* map, const char* key,
+                        unsigned long long hash);
+static size_t open_find_entry(const HashMap* map, unsigned long long hash,
+                              size_t entry);
+static size_t open_find_free(const HashMap* map, unsigned long long hash);
+static void open_alloc(HashMap* map, size_t capacity);
+static void open_resize(HashMap* map, size_t new_capacity);
+static void open_put(HashMap* map, const char* key, unsigned long long hash,
+                     void* value);
+static void open_remove(HashMap* map, const char* key,
+                        unsigned long long hash);
+static void open_clear(HashMap* map);
 
 // public implementations
 
@@ -33,7 +76,16 @@ void hash_map_init(HashMap* map) {
         exit(1);
     }
     memset(map->entries, 0, sizeof(HashMapEntry*) * map->capacity);
+    map->dense = NULL;
+    dense_alloc(map);
+    map->reserved = 0;
     map->dynamic_alloc = 0;
+    map->borrow_keys = 0;
+    map->open_addressing = 0;
+    map->control = NULL;
+    map->indices = NULL;
+    map->slots = NULL;
+    map->deleted = 0;
 }
 
 HashMap* hash_map_create() {
@@ -47,14 +99,63 @@ HashMap* hash_map_create() {
     return map;
 }
 
+HashMap* hash_map_create_with_capacity(size_t count) {
+    HashMap* map = hash_map_create();
+    hash_map_reserve(map, count);
+    return map;
+}
+
+void hash_map_reserve(HashMap* map, size_t count) {
+    map->reserved = count;
+    if (map->open_addressing) {
+        size_t capacity = open_capacity(count);
+        if (capacity > map->capacity) open_resize(map, capacity);
+    } else {
+        size_t capacity = chained_capacity(count);
+        if (capacity > map->capacity) hash_map_resize(map, capacity);
+    }
+}
+
+void hash_map_borrow_keys(HashMap* map) { map->borrow_keys = 1; }
+
+void hash_map_open_addressing(HashMap* map) {
+    if (map->open_addressing) return;
+    HashMapEntry** dense = map->dense;
+    free(map->entries);
+    map->entries = NULL;
+    map->dense = NULL;
+    map->open_addressing = 1;
+    size_t count = map->size > map->reserved ? map->size : map->reserved;
+    open_alloc(map, open_capacity(count));
+
+    // move the entries into the slots in insertion order, the slots take
+    // over the keys
+    for (size_t i = 0; i < map->size; i++) {
+        HashMapSlot* entry = &map->slots[i];
+        entry->key = dense[i]->key;
+        entry->value = dense[i]->value;
+        entry->hash = dense[i]->hash;
+        free(dense[i]);
+        size_t slot = open_find_free(map, entry->hash);
+        set_control(map, slot, entry->hash & 0x7F);
+        map->indices[slot] = (unsigned int)i;
+    }
+    free(dense);
+}
+
 void hash_map_put(HashMap* map, const char* key, void* value) {
+    unsigned long long hash = hash_string(key);
+    if (map->open_addressing) {
+        open_put(map, key, hash, value);
+        return;
+    }
     if (map->size >= map->capacity * LOAD_FACTOR) {
         hash_map_resize(map, map->capacity * 2);
     }
-    unsigned int index = hash(key, map->capacity);
+    size_t index = hash % map->capacity;
     HashMapEntry* entry = map->entries[index];
     while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
             entry->value = value;
             return;
         }
@@ -65,18 +166,25 @@ void hash_map_put(HashMap* map, const char* key, void* value) {
         perror("Error allocating memory for hashmap entry");
         exit(1);
     }
-    entry->key = strdup(key);
+    entry->key = map->borrow_keys ? (char*)key : strdup(key);
     entry->value = value;
+    entry->hash = hash;
+    entry->position = map->size;
     entry->next = map->entries[index];
     map->entries[index] = entry;
-    map->size++;
+    map->dense[map->size++] = entry;
 }
 
 void* hash_map_get(HashMap* map, const char* key) {
-    unsigned int index = hash(key, map->capacity);
-    HashMapEntry* entry = map->entries[index];
+    unsigned long long hash = hash_string(key);
+    if (map->open_addressing) {
+        size_t slot = open_find(map, key, hash);
+        if (slot == map->capacity) return NULL;
+        return map->slots[map->indices[slot]].value;
+    }
+    HashMapEntry* entry = map->entries[hash % map->capacity];
     while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
             return entry->value;
         }
         entry = entry->next;
@@ -86,33 +194,43 @@ void* hash_map_get(HashMap* map, const char* key) {
 
 void* hash_map_get_random(HashMap* map) {
     if (map->size == 0) return NULL;
-    size_t stop = rand() % map->size;
-    size_t count = 0;
-    for (size_t i = 0; i < map->capacity; i++) {
-        HashMapEntry* entry = map->entries[i];
-        while (entry != NULL) {
-            if (count == stop) return entry->value;
-            entry = entry->next;
-            ++count;
-        }
-    }
+    size_t position = rand() % map->size;
+    if (map->open_addressing) return map->slots[position].value;
+    return map->dense[position]->value;
+}
+
+void* hash_map_get_random_with(HashMap* map, unsigned long long* state) {
+    if (map->size == 0) return NULL;
+    size_t position = next_random(state) % map->size;
+    if (map->open_addressing) return map->slots[position].value;
+    return map->dense[position]->value;
 }
 
 void hash_map_remove(HashMap* map, const char* key) {
-    unsigned int index = hash(key, map->capacity);
+    unsigned long long hash = hash_string(key);
+    if (map->open_addressing) {
+        open_remove(map, key, hash);
+        return;
+    }
+    size_t index = hash % map->capacity;
     HashMapEntry* entry = map->entries[index];
     HashMapEntry* prev = NULL;
     while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
             if (prev == NULL) {
                 map->entries[index] = entry->next;
             } else {
                 prev->next = entry->next;
             }
-            free(entry->key);
+            // move the last entry into the gap of the dense array
+            HashMapEntry* last = map->dense[--map->size];
+            map->dense[entry->position] = last;
+            last->position = entry->position;
+            if (!map->borrow_keys) free(entry->key);
             free(entry);
-            map->size--;
-            if (map->size <= map->capacity * (1 - LOAD_FACTOR)) {
+            // shrink far below the load factor and not below the reserve
+            if (map->size <= map->capacity * SHRINK_FACTOR &&
+                map->capacity / 2 >= chained_capacity(map->reserved)) {
                 hash_map_resize(map, map->capacity / 2);
             }
             return;
@@ -122,35 +240,89 @@ void hash_map_remove(HashMap* map, const char* key) {
     }
 }
 
+void hash_map_iter_begin(const HashMap* map, HashMapIterator* iter) {
+    iter->map = map;
+    iter->position = 0;
+    iter->key = NULL;
+    iter->value = NULL;
+}
+
+int hash_map_iter_next(HashMapIterator* iter) {
+    const HashMap* map = iter->map;
+    if (iter->position >= map->size) return 0;
+    if (map->open_addressing) {
+        const HashMapSlot* entry = &map->slots[iter->position++];
+        iter->key = entry->key;
+        iter->value = entry->value;
+    } else {
+        const HashMapEntry* entry = map->dense[iter->position++];
+        iter->key = entry->key;
+        iter->value = entry->value;
+    }
+    return 1;
+}
+
+void hash_map_for_each(const HashMap* map, HashMapCallback callback,
+                       void* context) {
+    HashMapIterator iter;
+    hash_map_iter_begin(map, &iter);
+    while (hash_map_iter_next(&iter)) callback(iter.key, iter.value, context);
+}
+
+size_t hash_map_memory(const HashMap* map) {
+    size_t bytes;
+    if (map->open_addressing) {
+        bytes = sizeof(unsigned char) * (map->capacity + GROUP_WIDTH);
+        bytes += sizeof(unsigned int) * map->capacity;
+        bytes += sizeof(HashMapSlot) * (map->capacity / 8 * 7);
+    } else {
+        bytes = (sizeof(HashMapEntry*) * 2) * map->capacity;
+        bytes += sizeof(HashMapEntry) * map->size;
+    }
+    if (map->dynamic_alloc) bytes += sizeof(HashMap);
+    return bytes;
+}
+
 void hash_map_print(HashMap* map) {
-    for (size_t i = 0; i < map->capacity; i++) {
+    for (size_t i = 0; map->open_addressing && i < map->size; i++) {
+        printf("{%s (i=%zu): %p}\n", map->slots[i].key, i,
+               map->slots[i].value);
+    }
+    for (size_t i = 0; !map->open_addressing && i < map->capacity; i++) {
         HashMapEntry* entry = map->entries[i];
         while (entry != NULL) {
-            printf("{%s (i=%d): %p}\n", entry->key,
-                   hash(entry->key, map->capacity), entry->value);
+            printf("{%s (i=%zu): %p}\n", entry->key,
+                   (size_t)(entry->hash % map->capacity), entry->value);
             entry = entry->next;
         }
     }
 }
 
 void hash_map_clear(HashMap* map) {
-    for (size_t i = 0; i < map->capacity; i++) {
-        HashMapEntry* entry = map->entries[i];
-        while (entry != NULL) {
-            HashMapEntry* next = entry->next;
-            free(entry->key);
-            free(entry);
-            entry = next;
-        }
-        map->entries[i] = NULL;
+    if (map->open_addressing) {
+        open_clear(map);
+        return;
+    }
+    for (size_t i = 0; i < map->size; i++) {
+        if (!map->borrow_keys) free(map->dense[i]->key);
+        free(map->dense[i]);
     }
+    memset(map->entries, 0, sizeof(HashMapEntry*) * map->capacity);
     map->size = 0;
 }
 
 void hash_map_free(HashMap* map) {
     hash_map_clear(map);
     free(map->entries);
+    free(map->dense);
+    free(map->control);
+    free(map->indices);
+    free(map->slots);
     map->entries = NULL;
+    map->dense = NULL;
+    map->control = NULL;
+    map->indices = NULL;
+    map->slots = NULL;
     map->size = 0;
     map->capacity = 0;
     if (map->dynamic_alloc) free(map);
@@ -158,17 +330,62 @@ void hash_map_free(HashMap* map) {
 
 // private implementations
 
-static unsigned int hash(const char* key, int capacity) {
-    unsigned int hash = 0;
-    for (int i = 0; i < strlen(key); i++) {
-        hash = hash * 31 + key[i];
+// Multiply to 128 bits and fold the halves (wyhash mum).
+static unsigned long long mix(unsigned long long a, unsigned long long b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    return (unsigned long long)product ^ (unsigned long long)(product >> 64);
+#else
+    unsigned long long a_high = a >> 32, a_low = (unsigned int)a;
+    unsigned long long b_high = b >> 32, b_low = (unsigned int)b;
+    unsigned long long high = a_high * b_high, low = a_low * b_low;
+    unsigned long long cross_a = a_high * b_low, cross_b = a_low * b_high;
+    unsigned long long middle = (low >> 32) + (unsigned int)cross_a + cross_b;
+    high += (cross_a >> 32) + (middle >> 32);
+    if (middle < cross_b) high += 1ull << 32;
+    return ((low & 0xFFFFFFFFull) | middle << 32) ^ high;
+#endif
+}
+
+// Hash a string in a single pass, eight bytes are mixed at once.
+static unsigned long long hash_string(const char* key) {
+    const unsigned char* c = (const unsigned char*)key;
+    unsigned long long hash = HASH_SEED;
+    unsigned long long word = 0;
+    size_t length = 0;
+    for (; *c != '\0'; ++c) {
+        word |= (unsigned long long)*c << (8 * (length & 7));
+        if ((++length & 7) == 0) {
+            hash = mix(word ^ HASH_WORD, hash ^ HASH_FINAL);
+            word = 0;
+        }
     }
-    return hash % capacity;
+    hash = mix(word ^ HASH_WORD, hash ^ length);
+    return mix(hash ^ HASH_SEED, HASH_FINAL);
 }
 
-static void hash_map_resize(HashMap* map, int new_capacity) {
+// Linear congruential generator (Knuth MMIX) on a caller owned state.
+static unsigned long long next_random(unsigned long long* state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state >> 33;
+}
+
+// Smallest bucket capacity to put the entries without resizing.
+static size_t chained_capacity(size_t count) {
+    size_t capacity = (size_t)(count / LOAD_FACTOR) + 1;
+    return capacity > INIT_CAPACITY ? capacity : INIT_CAPACITY;
+}
+
+// Smallest power of two slot capacity to put the entries without resizing.
+static size_t open_capacity(size_t count) {
+    size_t capacity = GROUP_WIDTH;
+    while (capacity * 7 < count * 8) capacity *= 2;
+    return capacity;
+}
+
+static void hash_map_resize(HashMap* map, size_t new_capacity) {
     HashMapEntry** old_entries = map->entries;
-    int old_capacity = map->capacity;
+    size_t old_capacity = map->capacity;
 
     map->capacity = new_capacity;
     map->entries = malloc(sizeof(HashMapEntry*) * map->capacity);
@@ -182,7 +399,7 @@ static void hash_map_resize(HashMap* map, int new_capacity) {
         HashMapEntry* entry = old_entries[i];
         while (entry != NULL) {
             HashMapEntry* next = entry->next;
-            unsigned int index = hash(entry->key, map->capacity);
+            size_t index = entry->hash % map->capacity;
             entry->next = map->entries[index];
             map->entries[index] = entry;
             entry = next;
@@ -190,4 +407,198 @@ static void hash_map_resize(HashMap* map, int new_capacity) {
     }
 
     free(old_entries);
+    dense_alloc(map);
+}
+
+// Size the dense array to the bucket capacity, the load factor keeps the
+// number of entries below it.
+static void dense_alloc(HashMap* map) {
+    size_t capacity = map->capacity > 0 ? map->capacity : 1;
+    map->dense = realloc(map->dense, sizeof(HashMapEntry*) * capacity);
+    if (map->dense == NULL) {
+        perror("Error allocating memory for hashmap dense array");
+        exit(1);
+    }
+}
+
+// Bit mask of the control bytes in a group equal to the given byte.
+static unsigned int group_match(const unsigned char* group,
+                                unsigned char byte) {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte));
+    return (unsigned int)_mm_movemask_epi8(match);
+#else
+    unsigned int bits = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i)
+        bits |= (unsigned int)(group[i] == byte) << i;
+    return bits;
+#endif
+}
+
+// Bit mask of the empty or deleted slots (high bit set) in a group.
+static unsigned int group_match_free(const unsigned char* group) {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned int)_mm_movemask_epi8(ctrl);
+#else
+    unsigned int bits = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i)
+        bits |= (unsigned int)(group[i] >> 7) << i;
+    return bits;
+#endif
+}
+
+// Index of the lowest set bit.
+static int lowest_bit(unsigned int bits) {
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int bit = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Set the control byte of a slot and its copy behind the last slot, which
+// lets groups starting near the end be loaded without wrapping around.
+static void set_control(HashMap* map, size_t slot, unsigned char byte) {
+    map->control[slot] = byte;
+    if (slot < GROUP_WIDTH) map->control[map->capacity + slot] = byte;
+}
+
+// Slot of a key or the capacity if the key is missing. The upper hash bits
+// select the first group, the lower 7 bits are stored in the control byte
+// and filter the slots before the hashes and keys are compared.
+static size_t open_find(const HashMap* map, const char* key,
+                        unsigned long long hash) {
+    size_t mask = map->capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    unsigned char tag = hash & 0x7F;
+    for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+        const unsigned char* group = map->control + pos;
+        for (unsigned int bits = group_match(group, tag); bits != 0;
+             bits &= bits - 1) {
+            size_t slot = (pos + lowest_bit(bits)) & mask;
+            const HashMapSlot* entry = &map->slots[map->indices[slot]];
+            if (entry->hash == hash && strcmp(entry->key, key) == 0)
+                return slot;
+        }
+        // an empty slot ends the probe sequence, the load factor keeps one
+        if (group_match(group, CTRL_EMPTY)) return map->capacity;
+        pos = (pos + step) & mask;
+    }
+}
+
+// Slot referring to an entry of the dense array with the given hash.
+static size_t open_find_entry(const HashMap* map, unsigned long long hash,
+                              size_t entry) {
+    size_t mask = map->capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+        for (unsigned int bits = group_match(map->control + pos, hash & 0x7F);
+             bits != 0; bits &= bits - 1) {
+            size_t slot = (pos + lowest_bit(bits)) & mask;
+            if (map->indices[slot] == entry) return slot;
+        }
+        pos = (pos + step) & mask;
+    }
+}
+
+// First empty or deleted slot on the probe sequence of a hash.
+static size_t open_find_free(const HashMap* map, unsigned long long hash) {
+    size_t mask = map->capacity - 1;
+    size_t pos = (hash >> 7) & mask;
+    for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+        unsigned int bits = group_match_free(map->control + pos);
+        if (bits != 0) return (pos + lowest_bit(bits)) & mask;
+        pos = (pos + step) & mask;
+    }
+}
+
+// Allocate the control bytes and slots of a capacity and size the dense
+// array of the entries to the maximum load (7/8) of the slots.
+static void open_alloc(HashMap* map, size_t capacity) {
+    map->capacity = capacity;
+    map->deleted = 0;
+    map->control = malloc(sizeof(unsigned char) * (capacity + GROUP_WIDTH));
+    map->indices = malloc(sizeof(unsigned int) * capacity);
+    map->slots = realloc(map->slots, sizeof(HashMapSlot) * (capacity / 8 * 7));
+    if (map->control == NULL || map->indices == NULL || map->slots == NULL) {
+        perror("Error allocating memory for hashmap slot array");
+        exit(1);
+    }
+    memset(map->control, CTRL_EMPTY, capacity + GROUP_WIDTH);
+}
+
+// Index the entries in new slots, which drops the tombstones. The stored
+// hashes place the entries without hashing the keys again, the dense array
+// of the entries is not moved.
+static void open_resize(HashMap* map, size_t new_capacity) {
+    free(map->control);
+    free(map->indices);
+    open_alloc(map, new_capacity);
+    for (size_t i = 0; i < map->size; i++) {
+        size_t slot = open_find_free(map, map->slots[i].hash);
+        set_control(map, slot, map->slots[i].hash & 0x7F);
+        map->indices[slot] = (unsigned int)i;
+    }
+}
+
+static void open_put(HashMap* map, const char* key, unsigned long long hash,
+                     void* value) {
+    size_t slot = open_find(map, key, hash);
+    if (slot < map->capacity) {
+        map->slots[map->indices[slot]].value = value;
+        return;
+    }
+
+    // grow at 7/8 used slots, or only rehash if most of them are tombstones
+    if ((map->size + map->deleted + 1) * 8 > map->capacity * 7) {
+        size_t capacity = map->capacity;
+        if ((map->size + 1) * 16 > capacity * 7) capacity *= 2;
+        open_resize(map, capacity);
+    }
+    slot = open_find_free(map, hash);
+    if (map->control[slot] == CTRL_DELETED) map->deleted--;
+    set_control(map, slot, hash & 0x7F);
+    map->indices[slot] = (unsigned int)map->size;
+    HashMapSlot* entry = &map->slots[map->size++];
+    entry->key = map->borrow_keys ? (char*)key : strdup(key);
+    entry->value = value;
+    entry->hash = hash;
+}
+
+static void open_remove(HashMap* map, const char* key,
+                        unsigned long long hash) {
+    size_t slot = open_find(map, key, hash);
+    if (slot == map->capacity) return;
+    size_t entry = map->indices[slot];
+    if (!map->borrow_keys) free(map->slots[entry].key);
+    set_control(map, slot, CTRL_DELETED);
+    map->deleted++;
+
+    // move the last entry into the gap of the dense array
+    size_t last = --map->size;
+    if (entry != last) {
+        map->slots[entry] = map->slots[last];
+        slot = open_find_entry(map, map->slots[entry].hash, last);
+        map->indices[slot] = (unsigned int)entry;
+    }
+    if (map->size <= map->capacity * SHRINK_FACTOR &&
+        map->capacity / 2 >= open_capacity(map->reserved)) {
+        open_resize(map, map->capacity / 2);
+    }
+}
+
+static void open_clear(HashMap* map) {
+    for (size_t i = 0; !map->borrow_keys && i < map->size; i++) {
+        free(map->slots[i].key);
+    }
+    memset(map->control, CTRL_EMPTY, map->capacity + GROUP_WIDTH);
+    map->size = 0;
+    map->deleted = 0;
 }
@@ -0,0 +1,81 @@
+/**
+ * @brief String pool data structure
+ * @file strpool.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include "osurs/ds/strpool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The minimal number of characters of a block. */
+#define BLOCK_CAPACITY 4096
+
+// private declarations
+
+static char* string_pool_alloc(StringPool* pool, size_t size);
+
+// public implementations
+
+StringPool* string_pool_create() {
+    StringPool* pool = malloc(sizeof(StringPool));
+    if (pool == NULL) {
+        perror("Error allocating memory for string pool");
+        exit(1);
+    }
+    hash_map_init(&pool->strings);
+    hash_map_borrow_keys(&pool->strings);
+    pool->blocks = NULL;
+    pool->bytes = 0;
+    return pool;
+}
+
+const char* string_pool_intern(StringPool* pool, const char* str) {
+    const char* interned = hash_map_get(&pool->strings, str);
+    if (interned != NULL) return interned;
+    size_t size = strlen(str) + 1;
+    char* copy = string_pool_alloc(pool, size);
+    memcpy(copy, str, size);
+    hash_map_put(&pool->strings, copy, copy);
+    pool->bytes += size;
+    return copy;
+}
+
+const char* string_pool_find(StringPool* pool, const char* str) {
+    return hash_map_get(&pool->strings, str);
+}
+
+void string_pool_free(StringPool* pool) {
+    hash_map_free(&pool->strings);
+    StringPoolBlock* block = pool->blocks;
+    while (block != NULL) {
+        StringPoolBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(pool);
+}
+
+// private implementations
+
+static char* string_pool_alloc(StringPool* pool, size_t size) {
+    StringPoolBlock* block = pool->blocks;
+    if (block == NULL || block->capacity - block->used < size) {
+        size_t capacity = size > BLOCK_CAPACITY ? size : BLOCK_CAPACITY;
+        block = malloc(sizeof(StringPoolBlock) + capacity);
+        if (block == NULL) {
+            perror("Error allocating memory for string pool block");
+            exit(1);
+        }
+        block->capacity = capacity;
+        block->used = 0;
+        block->next = pool->blocks;
+        pool->blocks = block;
+    }
+    char* data = block->data + block->used;
+    block->used += size;
+    return data;
+}
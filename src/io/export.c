@@ -13,10 +13,19 @@
 
 #define ENCODING "UTF-8"
 
+// Private declarations
+
+static void write_calendar(xmlTextWriterPtr writer, Calendar *calendar);
+static void write_reservation(xmlTextWriterPtr writer, Route *route,
+                              Trip *trip, Reservation *res);
+
+// Public definitions
+
 int export_network(Network *network, const char *filename) {
     char buf[32];
     int rc;
     xmlTextWriterPtr writer;
+    HashMapIterator iter;
 
     /* Initialize the library and check potential ABI mismatches
      * between the version it was compiled for and the actual shared
@@ -62,114 +71,114 @@ int export_network(Network *network, const char *filename) {
 
     // Nodes
     xmlTextWriterStartElement(writer, "nodes");
-    for (size_t i = 0; i < network->nodes->capacity; i++) {
-        HashMapEntry *entry = network->nodes->entries[i];
-        while (entry != NULL) {
-            Node *node = (Node *)entry->value;
-            xmlTextWriterStartElement(writer, "node");
-            sprintf(buf, "%s", node->id);
-            xmlTextWriterWriteAttribute(writer, "id", buf);
-            sprintf(buf, "%.5f", node->x);
-            xmlTextWriterWriteAttribute(writer, "x", buf);
-            sprintf(buf, "%.5f", node->y);
-            xmlTextWriterWriteAttribute(writer, "y", buf);
-            sprintf(buf, "%ld", node->routes->size);
-            xmlTextWriterWriteAttribute(writer, "routes", buf);
-            xmlTextWriterEndElement(writer);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->nodes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Node *node = (Node *)iter.value;
+        xmlTextWriterStartElement(writer, "node");
+        sprintf(buf, "%s", node->id);
+        xmlTextWriterWriteAttribute(writer, "id", buf);
+        sprintf(buf, "%.5f", node->x);
+        xmlTextWriterWriteAttribute(writer, "x", buf);
+        sprintf(buf, "%.5f", node->y);
+        xmlTextWriterWriteAttribute(writer, "y", buf);
+        sprintf(buf, "%d", node->route_count);
+        xmlTextWriterWriteAttribute(writer, "routes", buf);
+        xmlTextWriterEndElement(writer);
     }
     xmlTextWriterEndElement(writer);
 
     // Compositions
     xmlTextWriterStartElement(writer, "compositions");
-    for (size_t i = 0; i < network->compositions->capacity; i++) {
-        HashMapEntry *entry = network->compositions->entries[i];
-        while (entry != NULL) {
-            Composition *comp = (Composition *)entry->value;
-            xmlTextWriterStartElement(writer, "composition");
-            sprintf(buf, "%s", comp->id);
-            xmlTextWriterWriteAttribute(writer, "id", buf);
-            sprintf(buf, "%d", comp->seat_count);
-            xmlTextWriterWriteAttribute(writer, "seat_count", buf);
-            xmlTextWriterEndElement(writer);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->compositions, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Composition *comp = (Composition *)iter.value;
+        xmlTextWriterStartElement(writer, "composition");
+        sprintf(buf, "%s", comp->id);
+        xmlTextWriterWriteAttribute(writer, "id", buf);
+        sprintf(buf, "%d", comp->seat_count);
+        xmlTextWriterWriteAttribute(writer, "seat_count", buf);
+        xmlTextWriterEndElement(writer);
     }
     xmlTextWriterEndElement(writer);
 
     // Vehicles
     xmlTextWriterStartElement(writer, "vehicles");
-    for (size_t i = 0; i < network->vehicles->capacity; i++) {
-        HashMapEntry *entry = network->vehicles->entries[i];
-        while (entry != NULL) {
-            Vehicle *vehicle = (Vehicle *)entry->value;
-            xmlTextWriterStartElement(writer, "vehicle");
-            sprintf(buf, "%s", vehicle->id);
-            xmlTextWriterWriteAttribute(writer, "id", buf);
-            sprintf(buf, "%s", vehicle->composition->id);
-            xmlTextWriterWriteAttribute(writer, "cid", buf);
-            xmlTextWriterEndElement(writer);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->vehicles, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Vehicle *vehicle = (Vehicle *)iter.value;
+        xmlTextWriterStartElement(writer, "vehicle");
+        sprintf(buf, "%s", vehicle->id);
+        xmlTextWriterWriteAttribute(writer, "id", buf);
+        sprintf(buf, "%s", vehicle->composition->id);
+        xmlTextWriterWriteAttribute(writer, "cid", buf);
+        xmlTextWriterEndElement(writer);
     }
     xmlTextWriterEndElement(writer);
 
+    // Calendars, only written if the trips have service calendars
+    if (network->calendars->size > 0) {
+        xmlTextWriterStartElement(writer, "calendars");
+        hash_map_iter_begin(network->calendars, &iter);
+        while (hash_map_iter_next(&iter)) {
+            write_calendar(writer, (Calendar *)iter.value);
+        }
+        xmlTextWriterEndElement(writer);
+    }
+
     // Routes
     xmlTextWriterStartElement(writer, "routes");
-    for (size_t i = 0; i < network->routes->capacity; i++) {
-        HashMapEntry *entry = network->routes->entries[i];
-        while (entry != NULL) {
-            Route *route = (Route *)entry->value;
-            Stop *curr_stop = route->root_stop;
-            Trip *curr_trip = route->root_trip;
-
-            // Route
-            xmlTextWriterStartElement(writer, "route");
-            sprintf(buf, "%s", route->id);
-            xmlTextWriterWriteAttribute(writer, "id", buf);
-            sprintf(buf, "%ld", route->route_size);
-            xmlTextWriterWriteAttribute(writer, "stops", buf);
-            sprintf(buf, "%ld", route->trip_size);
-            xmlTextWriterWriteAttribute(writer, "trips", buf);
-
-            // Stops
-            xmlTextWriterStartElement(writer, "stops");
-            while (curr_stop != NULL) {
-                xmlTextWriterStartElement(writer, "stop");
-                compose_time(buf, curr_stop->arrival_offset);
-                xmlTextWriterWriteAttribute(writer, "arr_off", buf);
-                compose_time(buf, curr_stop->departure_offset);
-                xmlTextWriterWriteAttribute(writer, "dep_off", buf);
-                sprintf(buf, "%s", curr_stop->node->id);
-                xmlTextWriterWriteAttribute(writer, "nid", buf);
-                xmlTextWriterEndElement(writer);
-                curr_stop = curr_stop->next;
-            }
-            xmlTextWriterEndElement(writer);
-
-            // Trips
-            xmlTextWriterStartElement(writer, "trips");
-            while (curr_trip != NULL) {
-                xmlTextWriterStartElement(writer, "trip");
-                sprintf(buf, "%s", curr_trip->id);
-                xmlTextWriterWriteAttribute(writer, "id", buf);
-                compose_time(buf, curr_trip->departure);
-                xmlTextWriterWriteAttribute(writer, "dep", buf);
-                compose_time(buf, curr_trip->arrival);
-                xmlTextWriterWriteAttribute(writer, "arr", buf);
-                sprintf(buf, "%s", curr_trip->vehicle->id);
-                xmlTextWriterWriteAttribute(writer, "vid", buf);
-                xmlTextWriterEndElement(writer);
-                curr_trip = curr_trip->next;
-            }
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Route *route = (Route *)iter.value;
+        Stop *curr_stop = route->root_stop;
+        Trip *curr_trip = route->root_trip;
+
+        // Route
+        xmlTextWriterStartElement(writer, "route");
+        sprintf(buf, "%s", route->id);
+        xmlTextWriterWriteAttribute(writer, "id", buf);
+        sprintf(buf, "%ld", route->route_size);
+        xmlTextWriterWriteAttribute(writer, "stops", buf);
+        sprintf(buf, "%ld", route->trip_size);
+        xmlTextWriterWriteAttribute(writer, "trips", buf);
+
+        // Stops
+        xmlTextWriterStartElement(writer, "stops");
+        while (curr_stop != NULL) {
+            xmlTextWriterStartElement(writer, "stop");
+            compose_time(buf, curr_stop->arrival_offset);
+            xmlTextWriterWriteAttribute(writer, "arr_off", buf);
+            compose_time(buf, curr_stop->departure_offset);
+            xmlTextWriterWriteAttribute(writer, "dep_off", buf);
+            sprintf(buf, "%s", curr_stop->node->id);
+            xmlTextWriterWriteAttribute(writer, "nid", buf);
             xmlTextWriterEndElement(writer);
+            curr_stop = curr_stop->next;
+        }
+        xmlTextWriterEndElement(writer);
 
-            // Close route
+        // Trips
+        xmlTextWriterStartElement(writer, "trips");
+        while (curr_trip != NULL) {
+            xmlTextWriterStartElement(writer, "trip");
+            sprintf(buf, "%s", curr_trip->id);
+            xmlTextWriterWriteAttribute(writer, "id", buf);
+            compose_time(buf, curr_trip->departure);
+            xmlTextWriterWriteAttribute(writer, "dep", buf);
+            compose_time(buf, curr_trip->arrival);
+            xmlTextWriterWriteAttribute(writer, "arr", buf);
+            sprintf(buf, "%s", curr_trip->vehicle->id);
+            xmlTextWriterWriteAttribute(writer, "vid", buf);
+            if (curr_trip->calendar != NULL)
+                xmlTextWriterWriteAttribute(writer, "cal",
+                                            curr_trip->calendar->id);
             xmlTextWriterEndElement(writer);
-
-            entry = entry->next;
+            curr_trip = curr_trip->next;
         }
+        xmlTextWriterEndElement(writer);
+
+        // Close route
+        xmlTextWriterEndElement(writer);
     }
     xmlTextWriterEndElement(writer);
 
@@ -198,9 +207,18 @@ int export_network(Network *network, const char *filename) {
 }
 
 int export_reservations(Network *network, const char *filename) {
-    char buf[32];
+    NetworkSnapshot *snapshot = network_snapshot(network);
+    int rc = export_reservations_snapshot(snapshot, filename);
+    delete_network_snapshot(snapshot);
+    return rc;
+}
+
+int export_reservations_snapshot(NetworkSnapshot *snapshot,
+                                 const char *filename) {
+    Network *network = snapshot->network;
     int rc;
     xmlTextWriterPtr writer;
+    HashMapIterator iter;
 
     /* Initialize the library and check potential ABI mismatches
      * between the version it was compiled for and the actual shared
@@ -237,38 +255,31 @@ int export_reservations(Network *network, const char *filename) {
     xmlTextWriterStartElement(writer, "reservations");
 
     // Routes
-    for (size_t i = 0; i < network->routes->capacity; i++) {
-        HashMapEntry *entry = network->routes->entries[i];
-        while (entry != NULL) {
-            Route *route = (Route *)entry->value;
-            Stop *curr_stop = route->root_stop;
-            Trip *curr_trip = route->root_trip;
-
-            // Trips
-            while (curr_trip != NULL) {
-                // Reservations
-                if (curr_trip->reservations->size > 0) {
-                    for (size_t i = 0; i < curr_trip->reservations->size; ++i) {
-                        Reservation *res = (Reservation *)array_list_get(
-                            curr_trip->reservations, i);
-                        xmlTextWriterStartElement(writer, "reservation");
-                        xmlTextWriterWriteAttribute(writer, "id", res->id);
-                        sprintf(buf, "%s", route->id);
-                        xmlTextWriterWriteAttribute(writer, "rid", buf);
-                        sprintf(buf, "%s", curr_trip->id);
-                        xmlTextWriterWriteAttribute(writer, "tid", buf);
-                        sprintf(buf, "%s", res->orig->node->id);
-                        xmlTextWriterWriteAttribute(writer, "nid_orig", buf);
-                        sprintf(buf, "%s", res->dest->node->id);
-                        xmlTextWriterWriteAttribute(writer, "nid_dest", buf);
-                        sprintf(buf, "%d", res->seats);
-                        xmlTextWriterWriteAttribute(writer, "seats", buf);
-                        xmlTextWriterEndElement(writer);
-                    }
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Route *route = (Route *)iter.value;
+        Trip *curr_trip = route->root_trip;
+
+        // Trips
+        while (curr_trip != NULL) {
+            // Reservations booked before the snapshot
+            size_t count = snapshot_reservation_count(snapshot, curr_trip);
+            for (size_t i = 0; i < count; ++i) {
+                write_reservation(writer, route, curr_trip,
+                                  snapshot_reservation(snapshot, curr_trip, i));
+            }
+            // Reservations on the service days of the trip
+            int day_count = snapshot_service_day_count(snapshot, curr_trip);
+            for (int d = 0; d < day_count; ++d) {
+                ServiceDay *day = snapshot_service_day(snapshot, curr_trip, d);
+                count = snapshot_service_day_reservation_count(snapshot, day);
+                for (size_t i = 0; i < count; ++i) {
+                    write_reservation(
+                        writer, route, curr_trip,
+                        snapshot_service_day_reservation(snapshot, day, i));
                 }
-                curr_trip = curr_trip->next;
             }
-            entry = entry->next;
+            curr_trip = curr_trip->next;
         }
     }
 
@@ -295,3 +306,44 @@ int export_reservations(Network *network, const char *filename) {
 
     return 1;
 }
+
+// Private definitions
+
+static void write_calendar(xmlTextWriterPtr writer, Calendar *calendar) {
+    char buf[32];
+    xmlTextWriterStartElement(writer, "calendar");
+    xmlTextWriterWriteAttribute(writer, "id", calendar->id);
+    sprintf(buf, "%d", calendar->first_day);
+    xmlTextWriterWriteAttribute(writer, "first", buf);
+    // One character per date, '1' for a service day
+    char *days = (char *)malloc(calendar->day_count + 1);
+    for (int i = 0; i < calendar->day_count; ++i)
+        days[i] = calendar_has_day(calendar, calendar->first_day + i) ? '1'
+                                                                      : '0';
+    days[calendar->day_count] = '\0';
+    xmlTextWriterWriteAttribute(writer, "days", days);
+    free(days);
+    xmlTextWriterEndElement(writer);
+}
+
+static void write_reservation(xmlTextWriterPtr writer, Route *route,
+                              Trip *trip, Reservation *res) {
+    char buf[32];
+    xmlTextWriterStartElement(writer, "reservation");
+    xmlTextWriterWriteAttribute(writer, "id", res->id);
+    sprintf(buf, "%s", route->id);
+    xmlTextWriterWriteAttribute(writer, "rid", buf);
+    sprintf(buf, "%s", trip->id);
+    xmlTextWriterWriteAttribute(writer, "tid", buf);
+    sprintf(buf, "%s", res->orig->node->id);
+    xmlTextWriterWriteAttribute(writer, "nid_orig", buf);
+    sprintf(buf, "%s", res->dest->node->id);
+    xmlTextWriterWriteAttribute(writer, "nid_dest", buf);
+    sprintf(buf, "%d", res->seats);
+    xmlTextWriterWriteAttribute(writer, "seats", buf);
+    if (res->date >= 0) {
+        sprintf(buf, "%d", res->date);
+        xmlTextWriterWriteAttribute(writer, "date", buf);
+    }
+    xmlTextWriterEndElement(writer);
+}
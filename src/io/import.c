@@ -8,6 +8,7 @@
 #include <libxml/parser.h>
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "osurs/io.h"
 #include "utils.h"
@@ -25,9 +26,11 @@ static void delete_carrier(Carrier *carrier);
 static void network_parser(xmlNode *xml_node, Carrier *carrier);
 static void reservation_parser(xmlNode *xml_node, Network *network,
                                Route *route, Trip *trip);
+static void handle_network(xmlNode *xml_node, Network *network);
 static void handle_node(xmlNode *xml_node, Network *network);
 static void handle_composition(xmlNode *xml_node, Network *network);
 static void handle_vehicle(xmlNode *xml_node, Network *network);
+static void handle_calendar(xmlNode *xml_node, Network *network);
 static void handle_route(xmlNode *xml_node, Carrier *carrier);
 static void handle_stop(xmlNode *xml_node, Carrier *carrier);
 static void handle_trip(xmlNode *xml_node, Carrier *carrier);
@@ -92,6 +95,7 @@ typedef struct carrier_t {
     const char **trip_ids;
     int *departures;
     struct vehicle_t **vehicles;
+    struct calendar_t **calendars;
     size_t trip_count;
     size_t trip_size;
     int init_state;
@@ -114,6 +118,7 @@ static void empty_carrier(Carrier *carrier) {
     free(carrier->trip_ids);
     free(carrier->departures);
     free(carrier->vehicles);
+    free(carrier->calendars);
 }
 
 static Carrier *init_carrier(Carrier *carrier, char *route_id,
@@ -127,6 +132,7 @@ static Carrier *init_carrier(Carrier *carrier, char *route_id,
     carrier->trip_ids = (const char **)malloc(sizeof(char *) * trip_size);
     carrier->departures = (int *)malloc(sizeof(int) * trip_size);
     carrier->vehicles = (Vehicle **)malloc(sizeof(Vehicle) * trip_size);
+    carrier->calendars = (Calendar **)malloc(sizeof(Calendar *) * trip_size);
     carrier->trip_size = trip_size;
     carrier->trip_count = 0;
     carrier->init_state = 1;
@@ -134,10 +140,15 @@ static Carrier *init_carrier(Carrier *carrier, char *route_id,
 }
 
 static void new_route_from_carrier(Carrier *carrier) {
-    new_route(carrier->network, carrier->route_id, carrier->nodes,
-              carrier->arrival_offsets, carrier->departure_offsets,
-              carrier->route_size, carrier->trip_ids, carrier->departures,
-              carrier->vehicles, carrier->trip_size);
+    Route *route = new_route(
+        carrier->network, carrier->route_id, carrier->nodes,
+        carrier->arrival_offsets, carrier->departure_offsets,
+        carrier->route_size, carrier->trip_ids, carrier->departures,
+        carrier->vehicles, carrier->trip_size);
+    // Set the service calendars of the trips
+    size_t i = 0;
+    for (Trip *trip = route->root_trip; trip != NULL; trip = trip->next)
+        trip->calendar = carrier->calendars[i++];
 }
 
 static void delete_carrier(Carrier *carrier) {
@@ -148,12 +159,16 @@ static void delete_carrier(Carrier *carrier) {
 static void network_parser(xmlNode *xml_node, Carrier *carrier) {
     while (xml_node) {
         if (xml_node->type == XML_ELEMENT_NODE) {
-            if (xmlStrcmp(xml_node->name, "node") == 0) {
+            if (xmlStrcmp(xml_node->name, "network") == 0) {
+                handle_network(xml_node, carrier->network);
+            } else if (xmlStrcmp(xml_node->name, "node") == 0) {
                 handle_node(xml_node, carrier->network);
             } else if (xmlStrcmp(xml_node->name, "composition") == 0) {
                 handle_composition(xml_node, carrier->network);
             } else if (xmlStrcmp(xml_node->name, "vehicle") == 0) {
                 handle_vehicle(xml_node, carrier->network);
+            } else if (xmlStrcmp(xml_node->name, "calendar") == 0) {
+                handle_calendar(xml_node, carrier->network);
             } else if (xmlStrcmp(xml_node->name, "route") == 0) {
                 handle_route(xml_node, carrier);
             } else if (xmlStrcmp(xml_node->name, "stop") == 0) {
@@ -178,6 +193,7 @@ static void reservation_parser(xmlNode *xml_node, Network *network,
                 char *nid_orig_tmp = xmlGetProp(xml_node, "nid_orig");
                 char *nid_dest_tmp = xmlGetProp(xml_node, "nid_dest");
                 char *seats_tmp = xmlGetProp(xml_node, "seats");
+                char *date_tmp = xmlGetProp(xml_node, "date");
 
                 // Get route
                 if (route == NULL || xmlStrcmp(rid_tmp, route->id) != 0) {
@@ -185,12 +201,9 @@ static void reservation_parser(xmlNode *xml_node, Network *network,
                 }
 
                 // Get trip
-                if (trip == NULL || xmlStrcmp(tid_tmp, trip->id) != 0) {
-                    trip = route->root_trip;
-                    while (trip) {
-                        if (xmlStrcmp(tid_tmp, trip->id) == 0) break;
-                        trip = trip->next;
-                    }
+                if (trip == NULL || trip->route != route ||
+                    xmlStrcmp(tid_tmp, trip->id) != 0) {
+                    trip = get_trip(route, tid_tmp);
                 }
 
                 // Get orig
@@ -217,6 +230,8 @@ static void reservation_parser(xmlNode *xml_node, Network *network,
                 conn->departure = 0;
                 conn->arrival = 1;
                 conn->available = INT_MAX;
+                conn->date = -1;
+                if (date_tmp != NULL) sscanf(date_tmp, "%d", &conn->date);
 
                 // Create new reservation
                 int seats;
@@ -236,6 +251,7 @@ static void reservation_parser(xmlNode *xml_node, Network *network,
                 xmlFree(nid_orig_tmp);
                 xmlFree(nid_dest_tmp);
                 xmlFree(seats_tmp);
+                xmlFree(date_tmp);
             }
         }
         reservation_parser(xml_node->children, network, route, trip);
@@ -243,6 +259,20 @@ static void reservation_parser(xmlNode *xml_node, Network *network,
     }
 }
 
+// Reserve the lookup maps for the counts in the root element, if given.
+static void handle_network(xmlNode *xml_node, Network *network) {
+    const char *names[] = {"nodes", "routes", "vehicles", "compositions"};
+    HashMap *maps[] = {network->nodes, network->routes, network->vehicles,
+                       network->compositions};
+    for (int i = 0; i < 4; ++i) {
+        size_t count;
+        char *count_tmp = xmlGetProp(xml_node, names[i]);
+        if (count_tmp != NULL && sscanf(count_tmp, "%zu", &count) == 1)
+            hash_map_reserve(maps[i], count);
+        xmlFree(count_tmp);
+    }
+}
+
 static void handle_node(xmlNode *xml_node, Network *network) {
     double x, y;
     char *id_tmp = xmlGetProp(xml_node, "id");
@@ -275,6 +305,22 @@ static void handle_vehicle(xmlNode *xml_node, Network *network) {
     xmlFree(cid_tmp);
 }
 
+static void handle_calendar(xmlNode *xml_node, Network *network) {
+    int first_day;
+    char *id_tmp = xmlGetProp(xml_node, "id");
+    char *first_tmp = xmlGetProp(xml_node, "first");
+    char *days_tmp = xmlGetProp(xml_node, "days");
+    sscanf(first_tmp, "%d", &first_day);
+    // One character per date, '1' for a service day
+    int day_count = (int)strlen(days_tmp);
+    Calendar *calendar = new_calendar(network, id_tmp, first_day, day_count);
+    for (int i = 0; i < day_count; ++i)
+        calendar_set_day(calendar, first_day + i, days_tmp[i] == '1');
+    xmlFree(id_tmp);
+    xmlFree(first_tmp);
+    xmlFree(days_tmp);
+}
+
 static void handle_route(xmlNode *xml_node, Carrier *carrier) {
     // Add Route if carrier already filled
     if (carrier->init_state == 1) {
@@ -319,13 +365,18 @@ static void handle_trip(xmlNode *xml_node, Carrier *carrier) {
     char *tid_tmp = xmlGetProp(xml_node, "id");  // Delete afterwards in carrier
     char *dep_tmp = xmlGetProp(xml_node, "dep");
     char *vid_tmp = xmlGetProp(xml_node, "vid");
+    char *cal_tmp = xmlGetProp(xml_node, "cal");
     int dep = parse_time(dep_tmp);
     Vehicle *vehicle = get_vehicle(carrier->network, vid_tmp);
+    Calendar *calendar =
+        cal_tmp == NULL ? NULL : get_calendar(carrier->network, cal_tmp);
     xmlFree(vid_tmp);
     xmlFree(dep_tmp);
+    xmlFree(cal_tmp);
     // Add trip
     carrier->trip_ids[carrier->trip_count] = tid_tmp;
     carrier->departures[carrier->trip_count] = dep;
     carrier->vehicles[carrier->trip_count] = vehicle;
+    carrier->calendars[carrier->trip_count] = calendar;
     ++(carrier->trip_count);
 }
@@ -13,10 +13,25 @@
 #define INDENT_CHARS ""
 #define INDENT_DEPTH 4
 
+// Private declarations
+
+static void print_trip_reservations(Trip *trip, NetworkSnapshot *snapshot,
+                                    int indent);
+static size_t day_reservation_count(Trip *trip, NetworkSnapshot *snapshot,
+                                    int d);
+static Reservation *day_reservation(Trip *trip, NetworkSnapshot *snapshot,
+                                    int d, size_t i);
+static void print_route_snapshot(Route *route, NetworkSnapshot *snapshot,
+                                 int indent);
+static void print_network_snapshot_of(Network *network,
+                                      NetworkSnapshot *snapshot);
+
+// Public definitions
+
 void print_node(Node *node, int indent) {
-    printf("%*s<node id=\"%s\" x=\"%.3f\" y=\"%.3f\" routes=\"%ld\" />\n",
+    printf("%*s<node id=\"%s\" x=\"%.3f\" y=\"%.3f\" routes=\"%d\" />\n",
            indent, INDENT_CHARS, node->id, node->x, node->y,
-           node->routes->size);
+           node->route_count);
 }
 
 void print_composition(Composition *composition, int indent) {
@@ -32,9 +47,11 @@ void print_vehicle(Vehicle *vehicle, int indent) {
 void print_reservation(Reservation *reservation, int indent) {
     printf(
         "%*s<reservation id=\"%s\" orig_nid=\"%s\" dest_nid=\"%s\" "
-        "seats=\"%d\" />\n",
+        "seats=\"%d\"",
         indent, INDENT_CHARS, reservation->id, reservation->orig->node->id,
         reservation->dest->node->id, reservation->seats);
+    if (reservation->date >= 0) printf(" date=\"%d\"", reservation->date);
+    printf(" />\n");
 }
 
 void print_seat(Seat *seat, int indent) {
@@ -52,27 +69,77 @@ void print_stop(Stop *stop, int indent) {
 }
 
 void print_trip(Trip *trip, int indent) {
+    print_trip_reservations(trip, NULL, indent);
+}
+
+// Print a trip with the reservations of a snapshot or all if NULL.
+static void print_trip_reservations(Trip *trip, NetworkSnapshot *snapshot,
+                                    int indent) {
     char departure[9];
     char arrival[9];
     compose_time(departure, trip->departure);
     compose_time(arrival, trip->arrival);
-    printf("%*s<trip id=\"%s\" dep=\"%s\" arr=\"%s\" vid=\"%s\" res=\"%ld\"",
-           indent, INDENT_CHARS, trip->id, departure, arrival,
-           trip->vehicle->id, trip->reservations->size);
-    if (trip->reservations->size > 0) {
+    size_t count = snapshot == NULL
+                       ? trip->reservations->size
+                       : snapshot_reservation_count(snapshot, trip);
+    int day_count = snapshot == NULL
+                        ? trip->service_day_count
+                        : snapshot_service_day_count(snapshot, trip);
+    size_t total = count;
+    for (int d = 0; d < day_count; ++d) {
+        total += day_reservation_count(trip, snapshot, d);
+    }
+    printf("%*s<trip id=\"%s\" dep=\"%s\" arr=\"%s\" vid=\"%s\" ", indent,
+           INDENT_CHARS, trip->id, departure, arrival, trip->vehicle->id);
+    if (trip->calendar != NULL) printf("cal=\"%s\" ", trip->calendar->id);
+    printf("res=\"%ld\"", total);
+    if (total > 0) {
         printf("\n");
-        for (int i = 0; i < trip->reservations->size; ++i) {
+        for (size_t i = 0; i < count; ++i) {
             print_reservation(
-                (Reservation *)array_list_get(trip->reservations, i),
+                snapshot == NULL
+                    ? (Reservation *)array_list_get(trip->reservations, i)
+                    : snapshot_reservation(snapshot, trip, i),
                 indent + INDENT_DEPTH);
         }
+        for (int d = 0; d < day_count; ++d) {
+            size_t day_res_count = day_reservation_count(trip, snapshot, d);
+            for (size_t i = 0; i < day_res_count; ++i) {
+                print_reservation(day_reservation(trip, snapshot, d, i),
+                                  indent + INDENT_DEPTH);
+            }
+        }
         printf("%*s</trip>\n", indent, INDENT_CHARS);
     } else {
         printf(" />\n");
     }
 }
 
+// Number of reservations on a service day of a trip in a snapshot or all.
+static size_t day_reservation_count(Trip *trip, NetworkSnapshot *snapshot,
+                                    int d) {
+    if (snapshot == NULL) return trip->service_days[d]->reservations->size;
+    ServiceDay *day = snapshot_service_day(snapshot, trip, d);
+    return snapshot_service_day_reservation_count(snapshot, day);
+}
+
+// Reservation on a service day of a trip in a snapshot or all if NULL.
+static Reservation *day_reservation(Trip *trip, NetworkSnapshot *snapshot,
+                                    int d, size_t i) {
+    if (snapshot == NULL)
+        return (Reservation *)array_list_get(
+            trip->service_days[d]->reservations, i);
+    ServiceDay *day = snapshot_service_day(snapshot, trip, d);
+    return snapshot_service_day_reservation(snapshot, day, i);
+}
+
 void print_route(Route *route, int indent) {
+    print_route_snapshot(route, NULL, indent);
+}
+
+// Print a route with the reservations of a snapshot or all if NULL.
+static void print_route_snapshot(Route *route, NetworkSnapshot *snapshot,
+                                 int indent) {
     Stop *curr_stop = route->root_stop;
     Trip *curr_trip = route->root_trip;
     printf("%*s<route id=\"%s\">\n", indent, INDENT_CHARS, route->id);
@@ -84,7 +151,8 @@ void print_route(Route *route, int indent) {
     printf("%*s</stops>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     printf("%*s<trips>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     while (curr_trip != NULL) {
-        print_trip(curr_trip, indent + 2 * INDENT_DEPTH);
+        print_trip_reservations(curr_trip, snapshot,
+                                indent + 2 * INDENT_DEPTH);
         curr_trip = curr_trip->next;
     }
     printf("%*s</trips>\n", indent + INDENT_DEPTH, INDENT_CHARS);
@@ -92,7 +160,18 @@ void print_route(Route *route, int indent) {
 }
 
 void print_network(Network *network) {
+    print_network_snapshot_of(network, NULL);
+}
+
+void print_network_snapshot(NetworkSnapshot *snapshot) {
+    print_network_snapshot_of(snapshot->network, snapshot);
+}
+
+// Print a network with the reservations of a snapshot or all if NULL.
+static void print_network_snapshot_of(Network *network,
+                                      NetworkSnapshot *snapshot) {
     int indent = 0;
+    HashMapIterator iter;
     // Network
     printf(
         "<network nodes=\"%ld\" composition=\"%ld\" vehicles=\"%ld\" "
@@ -101,44 +180,32 @@ void print_network(Network *network) {
         network->vehicles->size, network->routes->size);
     // Nodes
     printf("%*s<nodes>\n", indent + INDENT_DEPTH, INDENT_CHARS);
-    for (size_t i = 0; i < network->nodes->capacity; i++) {
-        HashMapEntry *entry = network->nodes->entries[i];
-        while (entry != NULL) {
-            print_node((Node *)entry->value, indent + 2 * INDENT_DEPTH);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->nodes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        print_node((Node *)iter.value, indent + 2 * INDENT_DEPTH);
     }
     printf("%*s</nodes>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     // Compositions
     printf("%*s<compositions>\n", indent + INDENT_DEPTH, INDENT_CHARS);
-    for (size_t i = 0; i < network->compositions->capacity; i++) {
-        HashMapEntry *entry = network->compositions->entries[i];
-        while (entry != NULL) {
-            print_composition((Composition *)entry->value,
-                              indent + 2 * INDENT_DEPTH);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->compositions, &iter);
+    while (hash_map_iter_next(&iter)) {
+        print_composition((Composition *)iter.value,
+                          indent + 2 * INDENT_DEPTH);
     }
     printf("%*s</compositions>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     // Vehicles
     printf("%*s<vehicles>\n", indent + INDENT_DEPTH, INDENT_CHARS);
-    for (size_t i = 0; i < network->vehicles->capacity; i++) {
-        HashMapEntry *entry = network->vehicles->entries[i];
-        while (entry != NULL) {
-            print_vehicle((Vehicle *)entry->value, indent + 2 * INDENT_DEPTH);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->vehicles, &iter);
+    while (hash_map_iter_next(&iter)) {
+        print_vehicle((Vehicle *)iter.value, indent + 2 * INDENT_DEPTH);
     }
     printf("%*s</vehicles>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     // Routes
     printf("%*s<routes>\n", indent + INDENT_DEPTH, INDENT_CHARS);
-    for (size_t i = 0; i < network->routes->capacity; i++) {
-        HashMapEntry *entry = network->routes->entries[i];
-        while (entry != NULL) {
-            Route *route = (Route *)entry->value;
-            print_route(route, indent + 2 * INDENT_DEPTH);
-            entry = entry->next;
-        }
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Route *route = (Route *)iter.value;
+        print_route_snapshot(route, snapshot, indent + 2 * INDENT_DEPTH);
     }
     printf("%*s</routes>\n", indent + INDENT_DEPTH, INDENT_CHARS);
     printf("</network>\n");
@@ -0,0 +1,35 @@
+/**
+ * @brief Service calendars of trips.
+ * @file calendar.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include "osurs/network.h"
+
+// Private declarations
+
+#define DAY_BITS ((int)sizeof(unsigned long long) * 8)
+
+// Public implementations
+
+void calendar_set_day(Calendar *calendar, int date, int active) {
+    int day = date - calendar->first_day;
+    if (day < 0 || day >= calendar->day_count) return;
+    unsigned long long bit = 1ull << (day % DAY_BITS);
+    if (active) {
+        calendar->days[day / DAY_BITS] |= bit;
+    } else {
+        calendar->days[day / DAY_BITS] &= ~bit;
+    }
+}
+
+int calendar_has_day(const Calendar *calendar, int date) {
+    int day = date - calendar->first_day;
+    if (day < 0 || day >= calendar->day_count) return 0;
+    return (calendar->days[day / DAY_BITS] >> (day % DAY_BITS)) & 1;
+}
+
+int trip_runs_on(const Trip *trip, int date) {
+    return trip->calendar == NULL || calendar_has_day(trip->calendar, date);
+}
@@ -5,22 +5,31 @@
  * @author: Merlin Unterfinger
  */
 
+#include <stdio.h>
 #include <string.h>
 
 #include "osurs/network.h"
 
 // Private declarations
 
-static Stop *new_stop(Node *node, Stop *prev, Stop *next, int arrival_offset,
-                      int departure_offset, size_t trip_size);
-static Trip *new_trip(const char *id, int departure, int arrival,
-                      Vehicle *vehicle, Trip *next, Route *route);
+static Stop *new_stop(Network *network, Node *node, Stop *prev, Stop *next,
+                      int ordinal, int arrival_offset, int departure_offset,
+                      size_t trip_size);
+static Trip *new_trip(Network *network, const char *id, int departure,
+                      int arrival, int ordinal, Vehicle *vehicle, Trip *next,
+                      Route *route);
+
+static int compare_trip_ids(const void *a, const void *b);
+static void route_index_trips(Network *network, Route *route);
 
 static void network_add_route(Network *network, Route *route);
+static void network_add_trip(Network *network, Trip *trip);
 static void network_add_node(Network *network, Node *node);
 static void network_add_vehicle(Network *network, Vehicle *vehicle);
 static void network_add_composition(Network *network, Composition *composition);
 static void node_add_route(Node *node, Route *route);
+static void trip_add_service_day(Trip *trip, ServiceDay *day);
+static size_t calendar_words(int day_count);
 
 // Public implementations
 
@@ -30,15 +39,40 @@ Network *new_network() {
     network->routes = hash_map_create();
     network->compositions = hash_map_create();
     network->vehicles = hash_map_create();
+    network->ids = string_pool_create();
+    network->arena = arena_create();
+    network->node_list = array_list_create();
+    network->route_list = array_list_create();
+    network->trip_list = array_list_create();
+    network->vehicle_list = array_list_create();
+    network->calendars = hash_map_create();
+    network->service_day_list = array_list_create();
+    network->stop_count = 0;
+    network->epoch = 0;
+    network->snapshots = array_list_create();
+    network->retired = array_list_create();
+    pthread_mutex_init(&network->lock, NULL);
+    network->cache_ops = NULL;
+    network->frozen_views = array_list_create();
+    // Keys are the interned identifiers of the network
+    hash_map_borrow_keys(network->nodes);
+    hash_map_borrow_keys(network->routes);
+    hash_map_borrow_keys(network->compositions);
+    hash_map_borrow_keys(network->vehicles);
+    hash_map_borrow_keys(network->calendars);
     return network;
 }
 
 Node *new_node(Network *network, const char *id, double x, double y) {
-    Node *node = (Node *)malloc(sizeof(Node));
-    node->id = strdup(id);
+    Node *node = (Node *)arena_alloc(network->arena, sizeof(Node));
+    node->id = string_pool_intern(network->ids, id);
+    node->index = (int)network->node_list->size;
     node->x = x;
     node->y = y;
-    node->routes = hash_map_create();
+    node->route_indices = NULL;
+    node->routes = NULL;
+    node->route_count = 0;
+    node->route_capacity = 0;
 
     // Add node to network
     network_add_node(network, node);
@@ -51,28 +85,33 @@ Route *new_route(Network *network, const char *id, Node *nodes[],
                  size_t route_size, const char *trip_ids[], int departures[],
                  Vehicle *vehicles[], size_t trip_size) {
     // Initialize route
-    Route *route = (Route *)malloc(sizeof(Route));
-    route->id = strdup(id);
+    Route *route = (Route *)arena_alloc(network->arena, sizeof(Route));
+    route->id = string_pool_intern(network->ids, id);
+    route->index = (int)network->route_list->size;
     route->route_size = route_size;
     route->trip_size = trip_size;
+    route->network = network;
 
     // Set root stop
-    Stop *root_stop = new_stop(nodes[0], NULL, NULL, arrival_offsets[0],
-                               departure_offsets[0], trip_size);
+    Stop *root_stop =
+        new_stop(network, nodes[0], NULL, NULL, 0, arrival_offsets[0],
+                 departure_offsets[0], trip_size);
     route->root_stop = root_stop;
 
     // Set root trip
-    Trip *root_trip = new_trip(trip_ids[0], departures[0],
-                               departures[0] + arrival_offsets[route_size - 1],
-                               vehicles[0], NULL, route);
+    Trip *root_trip =
+        new_trip(network, trip_ids[0], departures[0],
+                 departures[0] + arrival_offsets[route_size - 1], 0,
+                 vehicles[0], NULL, route);
     route->root_trip = root_trip;
 
     // Create chain of all stops
     Stop *prev_stop = root_stop;
     Stop *curr_stop;
     for (size_t i = 1; i < route_size; ++i) {
-        curr_stop = new_stop(nodes[i], prev_stop, NULL, arrival_offsets[i],
-                             departure_offsets[i], trip_size);
+        curr_stop = new_stop(network, nodes[i], prev_stop, NULL, (int)i,
+                             arrival_offsets[i], departure_offsets[i],
+                             trip_size);
         prev_stop->next = curr_stop;
         prev_stop = curr_stop;
     }
@@ -81,15 +120,20 @@ Route *new_route(Network *network, const char *id, Node *nodes[],
     Trip *prev_trip = root_trip;
     Trip *curr_trip;
     for (size_t i = 1; i < trip_size; ++i) {
-        curr_trip = new_trip(trip_ids[i], departures[i],
+        curr_trip = new_trip(network, trip_ids[i], departures[i],
                              departures[i] + arrival_offsets[route_size - 1],
-                             vehicles[i], NULL, route);
+                             (int)i, vehicles[i], NULL, route);
         prev_trip->next = curr_trip;
         prev_trip = curr_trip;
     }
 
-    // Add route to network
+    // Index the trips by identifier
+    route_index_trips(network, route);
+
+    // Add route and trips to network
     network_add_route(network, route);
+    for (Trip *trip = root_trip; trip != NULL; trip = trip->next)
+        network_add_trip(network, trip);
 
     // Add route to nodes
     for (size_t i = 0; i < route_size; ++i) node_add_route(nodes[i], route);
@@ -99,8 +143,10 @@ Route *new_route(Network *network, const char *id, Node *nodes[],
 
 Vehicle *new_vehicle(Network *network, const char *id,
                      Composition *composition) {
-    Vehicle *vehicle = (Vehicle *)malloc(sizeof(Vehicle));
-    vehicle->id = strdup(id);
+    Vehicle *vehicle =
+        (Vehicle *)arena_alloc(network->arena, sizeof(Vehicle));
+    vehicle->id = string_pool_intern(network->ids, id);
+    vehicle->index = (int)network->vehicle_list->size;
     vehicle->composition = composition;
 
     // Add vehicle to network
@@ -110,12 +156,14 @@ Vehicle *new_vehicle(Network *network, const char *id,
 }
 
 Composition *new_composition(Network *network, const char *id, int seat_count) {
-    Composition *composition = (Composition *)malloc(sizeof(Composition));
-    composition->id = strdup(id);
+    Composition *composition =
+        (Composition *)arena_alloc(network->arena, sizeof(Composition));
+    composition->id = string_pool_intern(network->ids, id);
     composition->seat_count = seat_count;
     // Generate a dummy seat_id array
     // Will be replaced with real seat id with final composition implementation
-    composition->seat_ids = (int *)malloc(sizeof(int) * seat_count);
+    composition->seat_ids =
+        (int *)arena_alloc(network->arena, sizeof(int) * seat_count);
     for (int i = 0; i < seat_count; ++i) {
         composition->seat_ids[i] = i + 100;
     }
@@ -126,39 +174,126 @@ Composition *new_composition(Network *network, const char *id, int seat_count) {
     return composition;
 }
 
+Calendar *new_calendar(Network *network, const char *id, int first_day,
+                       int day_count) {
+    Calendar *calendar =
+        (Calendar *)arena_alloc(network->arena, sizeof(Calendar));
+    calendar->id = string_pool_intern(network->ids, id);
+    calendar->first_day = first_day;
+    calendar->day_count = day_count > 0 ? day_count : 0;
+    calendar->days = (unsigned long long *)arena_calloc(
+        network->arena, calendar_words(calendar->day_count),
+        sizeof(unsigned long long));
+
+    // Add calendar to network
+    hash_map_put(network->calendars, calendar->id, (void *)calendar);
+
+    return calendar;
+}
+
+ServiceDay *new_service_day(Trip *trip, int date) {
+    ServiceDay *day = get_service_day(trip, date);
+    if (day != NULL) return day;
+    if (!trip_runs_on(trip, date)) return NULL;
+
+    // Allocate the service day on its first booking
+    Network *network = trip->route->network;
+    day = (ServiceDay *)arena_alloc(network->arena, sizeof(ServiceDay));
+    day->date = date;
+    day->index = (int)network->service_day_list->size;
+    day->trip = trip;
+    day->reserved = (int *)arena_calloc(
+        network->arena, trip->route->route_size, sizeof(int));
+    day->reserved_epoch = 0;
+    day->reservations = array_list_create();
+    day->reservations_epoch = 0;
+    array_list_add(network->service_day_list, (void *)day);
+    trip_add_service_day(trip, day);
+
+    return day;
+}
+
 // Private implementations
 
-static Stop *new_stop(Node *node, Stop *prev, Stop *next, int arrival_offset,
-                      int departure_offset, size_t trip_size) {
-    Stop *stop = (Stop *)malloc(sizeof(Stop));
+static size_t calendar_words(int day_count) {
+    size_t bits = sizeof(unsigned long long) * 8;
+    return ((size_t)day_count + bits - 1) / bits;
+}
+
+static Stop *new_stop(Network *network, Node *node, Stop *prev, Stop *next,
+                      int ordinal, int arrival_offset, int departure_offset,
+                      size_t trip_size) {
+    Stop *stop = (Stop *)arena_alloc(network->arena, sizeof(Stop));
     stop->node = node;
     stop->prev = prev;
     stop->next = next;
+    stop->ordinal = ordinal;
+    stop->index = network->stop_count++;
     stop->arrival_offset = arrival_offset;
     stop->departure_offset = departure_offset;
-    stop->reserved = (int *)calloc(trip_size, sizeof(int));  // Initialized to 0
+    stop->reserved =
+        (int *)arena_calloc(network->arena, trip_size, sizeof(int));
+    stop->reserved_epoch = 0;
     return stop;
 }
 
-static Trip *new_trip(const char *id, int departure, int arrival,
-                      Vehicle *vehicle, Trip *next, Route *route) {
-    Trip *trip = (Trip *)malloc(sizeof(Trip));
-    trip->id = strdup(id);
+static Trip *new_trip(Network *network, const char *id, int departure,
+                      int arrival, int ordinal, Vehicle *vehicle, Trip *next,
+                      Route *route) {
+    Trip *trip = (Trip *)arena_alloc(network->arena, sizeof(Trip));
+    trip->id = string_pool_intern(network->ids, id);
     trip->departure = departure;
     trip->arrival = arrival;
+    trip->ordinal = ordinal;
     trip->vehicle = vehicle;
     trip->next = next;
     trip->route = route;
     trip->reservations = array_list_create();
+    trip->reservations_epoch = 0;
+    trip->version = 0;
+    trip->cache = NULL;
+    trip->cache_version = 0;
+    trip->cache_strategy = -1;
+    trip->calendar = NULL;
+    trip->service_days = NULL;
+    trip->service_day_count = 0;
+    trip->service_day_capacity = 0;
+    trip->service_days_epoch = 0;
     return trip;
 }
 
+// Order trips by identifier, equal identifiers by their position.
+static int compare_trip_ids(const void *a, const void *b) {
+    const Trip *trip_a = *(const Trip **)a;
+    const Trip *trip_b = *(const Trip **)b;
+    int cmp = strcmp(trip_a->id, trip_b->id);
+    if (cmp != 0) return cmp;
+    return trip_a->ordinal - trip_b->ordinal;
+}
+
+static void route_index_trips(Network *network, Route *route) {
+    route->trip_index = (Trip **)arena_alloc(
+        network->arena, sizeof(Trip *) * route->trip_size);
+    size_t i = 0;
+    for (Trip *trip = route->root_trip; trip != NULL; trip = trip->next)
+        route->trip_index[i++] = trip;
+    qsort(route->trip_index, route->trip_size, sizeof(Trip *),
+          compare_trip_ids);
+}
+
 static void network_add_route(Network *network, Route *route) {
     hash_map_put(network->routes, route->id, (void *)route);
+    array_list_add(network->route_list, (void *)route);
+}
+
+static void network_add_trip(Network *network, Trip *trip) {
+    trip->index = (int)network->trip_list->size;
+    array_list_add(network->trip_list, (void *)trip);
 }
 
 static void network_add_node(Network *network, Node *node) {
     hash_map_put(network->nodes, node->id, (void *)node);
+    array_list_add(network->node_list, (void *)node);
 }
 
 static void network_add_composition(Network *network,
@@ -168,10 +303,40 @@ static void network_add_composition(Network *network,
 
 static void network_add_vehicle(Network *network, Vehicle *vehicle) {
     hash_map_put(network->vehicles, vehicle->id, (void *)vehicle);
+    array_list_add(network->vehicle_list, (void *)vehicle);
 }
 
 static void node_add_route(Node *node, Route *route) {
-    // Check if route already exists is not necessary; the hashmap overwrites
-    // already existing routes with the same id.
-    hash_map_put(node->routes, route->id, (void *)route);
+    // Routes are added in the order of their index, a route passing the node
+    // several times is only added once.
+    if (node->route_count > 0 &&
+        node->route_indices[node->route_count - 1] == route->index)
+        return;
+    if (node->route_count == node->route_capacity) {
+        node->route_capacity =
+            node->route_capacity == 0 ? 2 : node->route_capacity * 2;
+        node->route_indices = (int *)realloc(
+            node->route_indices, sizeof(int) * node->route_capacity);
+        node->routes = (Route **)realloc(
+            node->routes, sizeof(Route *) * node->route_capacity);
+        if (node->route_indices == NULL || node->routes == NULL) {
+            perror("Error allocating memory for node routes");
+            exit(1);
+        }
+    }
+    node->route_indices[node->route_count] = route->index;
+    node->routes[node->route_count++] = route;
+}
+
+static void trip_add_service_day(Trip *trip, ServiceDay *day) {
+    // Grown, or copied while shared with a snapshot
+    ServiceDay **service_days = trip_service_days_for_write(trip);
+    // Keep the days sorted by date, bookings mostly arrive in date order
+    int i = trip->service_day_count;
+    while (i > 0 && service_days[i - 1]->date > day->date) {
+        service_days[i] = service_days[i - 1];
+        --i;
+    }
+    service_days[i] = day;
+    ++trip->service_day_count;
 }
@@ -10,79 +10,66 @@
 // Private declarations
 
 static void delete_node(Node *node);
-static void delete_stop(Stop *stop);
-static void delete_composition(Composition *composition);
-static void delete_vehicle(Vehicle *vehicle);
+static void delete_stops(Route *route);
 static void delete_trip(Trip *trip);
-static void delete_route(Route *route);
+static void delete_service_day(ServiceDay *day);
 static void delete_reservation(Reservation *reservation);
 
 // Public implementations
 
-void delete_node(Node *node) {
-    free(node->id);
-    hash_map_free(node->routes);
-    free(node);
-}
-
 void delete_network(Network *network) {
-    // Free routes
-    for (size_t i = 0; i < network->routes->capacity; i++) {
-        HashMapEntry *entry = network->routes->entries[i];
-        while (entry != NULL) {
-            delete_route((Route *)entry->value);
-            entry = entry->next;
-        }
+    // Release the snapshots still alive
+    while (network->snapshots->size > 0) {
+        delete_network_snapshot(
+            (NetworkSnapshot *)
+                network->snapshots->elements[network->snapshots->size - 1]);
     }
-    // Free vehicles
-    for (size_t i = 0; i < network->vehicles->capacity; i++) {
-        HashMapEntry *entry = network->vehicles->entries[i];
-        while (entry != NULL) {
-            delete_vehicle((Vehicle *)entry->value);
-            entry = entry->next;
-        }
+    // Free the growable members, the structure is located in the arena
+    for (size_t i = 0; i < network->trip_list->size; ++i) {
+        delete_trip((Trip *)network->trip_list->elements[i]);
     }
-    // Free compositions
-    for (size_t i = 0; i < network->compositions->capacity; i++) {
-        HashMapEntry *entry = network->compositions->entries[i];
-        while (entry != NULL) {
-            delete_composition((Composition *)entry->value);
-            entry = entry->next;
-        }
+    for (size_t i = 0; i < network->node_list->size; ++i) {
+        delete_node((Node *)network->node_list->elements[i]);
     }
-    // Free nodes
-    for (size_t i = 0; i < network->nodes->capacity; i++) {
-        HashMapEntry *entry = network->nodes->entries[i];
-        while (entry != NULL) {
-            delete_node((Node *)entry->value);
-            entry = entry->next;
-        }
+    for (size_t i = 0; i < network->route_list->size; ++i) {
+        delete_stops((Route *)network->route_list->elements[i]);
     }
+
     // Free hashmaps
     hash_map_free(network->routes);
     hash_map_free(network->vehicles);
     hash_map_free(network->compositions);
     hash_map_free(network->nodes);
+    hash_map_free(network->calendars);
+    // Free index lists
+    array_list_free(network->node_list);
+    array_list_free(network->route_list);
+    array_list_free(network->trip_list);
+    array_list_free(network->vehicle_list);
+    array_list_free(network->service_day_list);
+    array_list_free(network->snapshots);
+    array_list_free(network->retired);
+    array_list_free(network->frozen_views);
+    pthread_mutex_destroy(&network->lock);
+    // Free identifiers and structure
+    string_pool_free(network->ids);
+    arena_free(network->arena);
     // Free struct
     free(network);
 }
 
 // Private implementations
 
-static void delete_stop(Stop *stop) {
-    free(stop->reserved);
-    free(stop);
+static void delete_node(Node *node) {
+    free(node->route_indices);
+    free(node->routes);
 }
 
-static void delete_composition(Composition *composition) {
-    free(composition->id);
-    free(composition->seat_ids);
-    free(composition);
-}
-
-static void delete_vehicle(Vehicle *vehicle) {
-    free(vehicle->id);
-    free(vehicle);
+// Free the reserved arrays copied on write, the originals are in the arena.
+static void delete_stops(Route *route) {
+    for (Stop *stop = route->root_stop; stop != NULL; stop = stop->next) {
+        if (stop->reserved_epoch > 0) free(stop->reserved);
+    }
 }
 
 static void delete_trip(Trip *trip) {
@@ -90,36 +77,21 @@ static void delete_trip(Trip *trip) {
         delete_reservation((Reservation*)array_list_get(trip->reservations, i));
     }
     array_list_free(trip->reservations);
-    free(trip->id);
-    free(trip);
+    // The cached result is released by the layer which created it
+    if (trip->cache != NULL) trip->route->network->cache_ops->free(trip->cache);
+    for (int i = 0; i < trip->service_day_count; ++i) {
+        delete_service_day(trip->service_days[i]);
+    }
+    free(trip->service_days);
 }
 
-static void delete_reservation(Reservation *reservation) { free(reservation); }
-
-static void delete_route(Route *route) {
-    // Free stops
-    Stop *next_stop;
-    Stop *curr_stop = route->root_stop;
-    while (1) {
-        next_stop = curr_stop->next;
-        delete_stop(curr_stop);
-        if (next_stop == NULL) {
-            break;
-        }
-        curr_stop = next_stop;
-    }
-    // Free trips
-    Trip *next_trip;
-    Trip *curr_trip = route->root_trip;
-    while (1) {
-        next_trip = curr_trip->next;
-        delete_trip(curr_trip);
-        if (next_trip == NULL) {
-            break;
-        }
-        curr_trip = next_trip;
+// Free the reservations of a service day, the day is in the arena.
+static void delete_service_day(ServiceDay *day) {
+    for (size_t i = 0; i < day->reservations->size; ++i) {
+        delete_reservation((Reservation *)array_list_get(day->reservations, i));
     }
-    // Free struct
-    free(route->id);
-    free(route);
+    array_list_free(day->reservations);
+    if (day->reserved_epoch > 0) free(day->reserved);
 }
+
+static void delete_reservation(Reservation *reservation) { free(reservation); }
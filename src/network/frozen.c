@@ -0,0 +1,182 @@
+/**
+ * @brief Frozen struct-of-arrays view of a network.
+ * @file frozen.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <string.h>
+
+#include "osurs/network.h"
+
+// Public implementations
+
+FrozenNetwork *freeze_network(Network *network) {
+    FrozenNetwork *frozen = (FrozenNetwork *)malloc(sizeof(FrozenNetwork));
+    frozen->network = network;
+
+    // Nodes and routes keep their dense index
+    frozen->node_count = (int)network->node_list->size;
+    frozen->nodes = (Node **)malloc(sizeof(Node *) * (frozen->node_count + 1));
+    memcpy(frozen->nodes, network->node_list->elements,
+           sizeof(Node *) * frozen->node_count);
+    frozen->route_count = (int)network->route_list->size;
+    frozen->routes =
+        (Route **)malloc(sizeof(Route *) * (frozen->route_count + 1));
+    memcpy(frozen->routes, network->route_list->elements,
+           sizeof(Route *) * frozen->route_count);
+
+    // Count the stops and trips of the routes
+    frozen->route_stop_start =
+        (int *)malloc(sizeof(int) * (frozen->route_count + 1));
+    frozen->route_trip_start =
+        (int *)malloc(sizeof(int) * (frozen->route_count + 1));
+    frozen->stop_count = 0;
+    frozen->trip_count = 0;
+    for (int r = 0; r < frozen->route_count; ++r) {
+        frozen->route_stop_start[r] = frozen->stop_count;
+        frozen->route_trip_start[r] = frozen->trip_count;
+        frozen->stop_count += (int)frozen->routes[r]->route_size;
+        frozen->trip_count += (int)frozen->routes[r]->trip_size;
+    }
+    frozen->route_stop_start[frozen->route_count] = frozen->stop_count;
+    frozen->route_trip_start[frozen->route_count] = frozen->trip_count;
+
+    // Stop sequences and offsets of all routes
+    frozen->stop_nodes = (int *)malloc(sizeof(int) * (frozen->stop_count + 1));
+    frozen->stop_arrival_offsets =
+        (int *)malloc(sizeof(int) * (frozen->stop_count + 1));
+    frozen->stop_departure_offsets =
+        (int *)malloc(sizeof(int) * (frozen->stop_count + 1));
+    frozen->stops = (Stop **)malloc(sizeof(Stop *) * (frozen->stop_count + 1));
+    frozen->trip_departures =
+        (int *)malloc(sizeof(int) * (frozen->trip_count + 1));
+    frozen->trip_arrivals = (int *)malloc(sizeof(int) * (frozen->trip_count + 1));
+    frozen->trip_capacities =
+        (int *)malloc(sizeof(int) * (frozen->trip_count + 1));
+    frozen->trips = (Trip **)malloc(sizeof(Trip *) * (frozen->trip_count + 1));
+    for (int r = 0; r < frozen->route_count; ++r) {
+        int s = frozen->route_stop_start[r];
+        for (Stop *stop = frozen->routes[r]->root_stop; stop != NULL;
+             stop = stop->next, ++s) {
+            frozen->stop_nodes[s] = stop->node->index;
+            frozen->stop_arrival_offsets[s] = stop->arrival_offset;
+            frozen->stop_departure_offsets[s] = stop->departure_offset;
+            frozen->stops[s] = stop;
+        }
+        int t = frozen->route_trip_start[r];
+        for (Trip *trip = frozen->routes[r]->root_trip; trip != NULL;
+             trip = trip->next, ++t) {
+            frozen->trip_departures[t] = trip->departure;
+            frozen->trip_arrivals[t] = trip->arrival;
+            frozen->trip_capacities[t] = trip->vehicle->composition->seat_count;
+            frozen->trips[t] = trip;
+        }
+    }
+
+    // Sorted routes passing each node
+    frozen->node_route_start =
+        (int *)calloc(frozen->node_count + 1, sizeof(int));
+    size_t node_route_count = 0;
+    for (int n = 0; n < frozen->node_count; ++n) {
+        frozen->node_route_start[n] = (int)node_route_count;
+        node_route_count += frozen->nodes[n]->route_count;
+    }
+    frozen->node_route_start[frozen->node_count] = (int)node_route_count;
+    frozen->node_routes = (int *)malloc(sizeof(int) * (node_route_count + 1));
+    for (int n = 0; n < frozen->node_count; ++n) {
+        if (frozen->nodes[n]->route_count == 0) continue;
+        memcpy(frozen->node_routes + frozen->node_route_start[n],
+               frozen->nodes[n]->route_indices,
+               sizeof(int) * frozen->nodes[n]->route_count);
+    }
+
+    // Reservation counts of each trip on the stops of its route, so that the
+    // search reads one contiguous range per trip; copied and registered under
+    // the lock, which the bookings hold to update the view
+    frozen->trip_reserved_start =
+        (int *)malloc(sizeof(int) * (frozen->trip_count + 1));
+    size_t reserved_count = 0;
+    for (int r = 0; r < frozen->route_count; ++r) {
+        int route_size = (int)frozen->routes[r]->route_size;
+        for (int t = frozen->route_trip_start[r];
+             t < frozen->route_trip_start[r + 1]; ++t) {
+            frozen->trip_reserved_start[t] = (int)reserved_count;
+            reserved_count += route_size;
+        }
+    }
+    frozen->trip_reserved_start[frozen->trip_count] = (int)reserved_count;
+    frozen->trip_reserved = (int *)malloc(sizeof(int) * (reserved_count + 1));
+    pthread_mutex_lock(&network->lock);
+    for (int r = 0; r < frozen->route_count; ++r) {
+        int first_stop = frozen->route_stop_start[r];
+        int first_trip = frozen->route_trip_start[r];
+        for (int t = first_trip; t < frozen->route_trip_start[r + 1]; ++t) {
+            int *reserved =
+                frozen->trip_reserved + frozen->trip_reserved_start[t];
+            for (int s = first_stop; s < frozen->route_stop_start[r + 1]; ++s)
+                reserved[s - first_stop] =
+                    frozen->stops[s]->reserved[t - first_trip];
+        }
+    }
+    array_list_add(network->frozen_views, frozen);
+    pthread_mutex_unlock(&network->lock);
+
+    return frozen;
+}
+
+int frozen_node_index(FrozenNetwork *frozen, const Node *node) {
+    if (node->index >= frozen->node_count) return -1;
+    if (frozen->nodes[node->index] != node) return -1;
+    return node->index;
+}
+
+void frozen_network_reserve(Trip *trip, const Stop *orig, const Stop *dest,
+                            int seats) {
+    Route *route = trip->route;
+    ArrayList *views = route->network->frozen_views;
+    for (size_t i = 0; i < views->size; ++i) {
+        FrozenNetwork *frozen = (FrozenNetwork *)views->elements[i];
+        // Routes and trips added after freezing are not part of the view
+        if (route->index >= frozen->route_count) continue;
+        int t = frozen->route_trip_start[route->index] + trip->ordinal;
+        if (t >= frozen->route_trip_start[route->index + 1]) continue;
+        int *reserved = frozen->trip_reserved + frozen->trip_reserved_start[t];
+        for (int s = orig->ordinal; s <= dest->ordinal; ++s)
+            reserved[s] += seats;
+    }
+}
+
+void delete_frozen_network(FrozenNetwork *frozen) {
+    if (frozen == NULL) return;
+
+    // Stop updating the view
+    Network *network = frozen->network;
+    pthread_mutex_lock(&network->lock);
+    ArrayList *views = network->frozen_views;
+    for (size_t i = 0; i < views->size; ++i) {
+        if (views->elements[i] == frozen) {
+            views->elements[i] = views->elements[--views->size];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&network->lock);
+
+    free(frozen->trip_reserved);
+    free(frozen->trip_reserved_start);
+    free(frozen->trips);
+    free(frozen->trip_capacities);
+    free(frozen->trip_arrivals);
+    free(frozen->trip_departures);
+    free(frozen->stops);
+    free(frozen->stop_departure_offsets);
+    free(frozen->stop_arrival_offsets);
+    free(frozen->stop_nodes);
+    free(frozen->route_trip_start);
+    free(frozen->route_stop_start);
+    free(frozen->routes);
+    free(frozen->node_routes);
+    free(frozen->node_route_start);
+    free(frozen->nodes);
+    free(frozen);
+}
@@ -46,14 +46,68 @@ Route *get_route(Network *network, const char *id) {
     return route;
 }
 
+Calendar *get_calendar(Network *network, const char *id) {
+    Calendar *calendar = (Calendar *)hash_map_get(network->calendars, id);
+    if (calendar == NULL) {
+        printf("Calendar %s not found.\n", id);
+    }
+    return calendar;
+}
+
+ServiceDay *get_service_day(Trip *trip, int date) {
+    // Binary search on the service days sorted by date
+    int low = 0;
+    int high = trip->service_day_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (trip->service_days[mid]->date < date) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < trip->service_day_count &&
+        trip->service_days[low]->date == date)
+        return trip->service_days[low];
+    return NULL;
+}
+
 Trip *get_trip(Route *route, const char *id) {
-    Trip *curr_trip = route->root_trip;
-    while (curr_trip) {
-        if (strcmp(curr_trip->id, id) == 0) return curr_trip;
-        curr_trip = curr_trip->next;
+    // Binary search for the first trip with the identifier
+    size_t low = 0;
+    size_t high = route->trip_size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (strcmp(route->trip_index[mid]->id, id) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    if (low < route->trip_size && strcmp(route->trip_index[low]->id, id) == 0)
+        return route->trip_index[low];
     printf("Trip %s not found.\n", id);
     return NULL;
 }
 
+Node *network_node_at(Network *network, int index) {
+    if (index < 0 || index >= (int)network->node_list->size) return NULL;
+    return (Node *)network->node_list->elements[index];
+}
+
+Route *network_route_at(Network *network, int index) {
+    if (index < 0 || index >= (int)network->route_list->size) return NULL;
+    return (Route *)network->route_list->elements[index];
+}
+
+Trip *network_trip_at(Network *network, int index) {
+    if (index < 0 || index >= (int)network->trip_list->size) return NULL;
+    return (Trip *)network->trip_list->elements[index];
+}
+
+Vehicle *network_vehicle_at(Network *network, int index) {
+    if (index < 0 || index >= (int)network->vehicle_list->size) return NULL;
+    return (Vehicle *)network->vehicle_list->elements[index];
+}
+
 // Private implementations
@@ -0,0 +1,165 @@
+/**
+ * @brief Memory accounting of networks.
+ * @file memory.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <string.h>
+
+#include "osurs/network.h"
+
+// Private declarations
+
+static void add_usage(MemoryUsage *usage, size_t count, size_t bytes);
+static size_t array_list_memory(const ArrayList *list);
+
+// Public implementations
+
+NetworkMemoryStats network_memory_stats(Network *network) {
+    NetworkMemoryStats stats;
+    memset(&stats, 0, sizeof(NetworkMemoryStats));
+
+    // Nodes and their route arrays
+    for (size_t i = 0; i < network->node_list->size; ++i) {
+        Node *node = (Node *)network->node_list->elements[i];
+        add_usage(&stats.nodes, 1, arena_alloc_size(sizeof(Node)));
+        add_usage(&stats.node_routes, node->route_count,
+                  (sizeof(int) + sizeof(Route *)) * node->route_capacity);
+    }
+
+    // Routes with their stops and trip indices
+    for (size_t i = 0; i < network->route_list->size; ++i) {
+        Route *route = (Route *)network->route_list->elements[i];
+        add_usage(&stats.routes, 1,
+                  arena_alloc_size(sizeof(Route)) +
+                      arena_alloc_size(sizeof(Trip *) * route->trip_size));
+        for (Stop *stop = route->root_stop; stop != NULL; stop = stop->next) {
+            add_usage(&stats.stops, 1, arena_alloc_size(sizeof(Stop)));
+            add_usage(&stats.occupancy, route->trip_size,
+                      arena_alloc_size(sizeof(int) * route->trip_size));
+            // Copied on write while shared with a snapshot
+            if (stop->reserved_epoch > 0)
+                add_usage(&stats.occupancy, 0,
+                          sizeof(int) * route->trip_size);
+        }
+    }
+
+    // Trips with their reservations and cached results
+    for (size_t i = 0; i < network->trip_list->size; ++i) {
+        Trip *trip = (Trip *)network->trip_list->elements[i];
+        add_usage(&stats.trips, 1, arena_alloc_size(sizeof(Trip)));
+        add_usage(&stats.reservations, trip->reservations->size,
+                  sizeof(Reservation) * trip->reservations->size +
+                      array_list_memory(trip->reservations));
+        if (trip->cache != NULL)
+            add_usage(&stats.seat_collections, 1,
+                      network->cache_ops->memory(trip->cache));
+        add_usage(&stats.hash_maps, 0,
+                  sizeof(ServiceDay *) * trip->service_day_capacity);
+    }
+
+    // Service days booked on the calendars of the trips
+    for (size_t i = 0; i < network->service_day_list->size; ++i) {
+        ServiceDay *day = (ServiceDay *)network->service_day_list->elements[i];
+        size_t route_size = day->trip->route->route_size;
+        add_usage(&stats.service_days, 1, arena_alloc_size(sizeof(ServiceDay)));
+        add_usage(&stats.occupancy, route_size,
+                  arena_alloc_size(sizeof(int) * route_size));
+        if (day->reserved_epoch > 0)
+            add_usage(&stats.occupancy, 0, sizeof(int) * route_size);
+        add_usage(&stats.reservations, day->reservations->size,
+                  sizeof(Reservation) * day->reservations->size +
+                      array_list_memory(day->reservations));
+    }
+
+    // Reserved arrays kept for snapshots and the snapshots
+    for (size_t i = 0; i < network->retired->size; ++i) {
+        RetiredPage *retired = (RetiredPage *)network->retired->elements[i];
+        add_usage(&stats.occupancy, 0, sizeof(RetiredPage));
+        if (!retired->in_arena)
+            add_usage(&stats.occupancy, 0, retired->size);
+    }
+    for (size_t i = 0; i < network->snapshots->size; ++i) {
+        NetworkSnapshot *snapshot =
+            (NetworkSnapshot *)network->snapshots->elements[i];
+        size_t trip_count = (size_t)snapshot->trip_count;
+        size_t day_count = (size_t)snapshot->service_day_count;
+        add_usage(&stats.snapshots, 1,
+                  sizeof(NetworkSnapshot) +
+                      sizeof(int *) * (snapshot->stop_count + 1) +
+                      2 * sizeof(SnapshotList) * (trip_count + 1) +
+                      (sizeof(int *) + sizeof(SnapshotList)) *
+                          (day_count + 1));
+    }
+
+    // Vehicles, compositions and calendars
+    HashMapIterator iter;
+    add_usage(&stats.vehicles, network->vehicle_list->size,
+              arena_alloc_size(sizeof(Vehicle)) * network->vehicle_list->size);
+    hash_map_iter_begin(network->compositions, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Composition *composition = (Composition *)iter.value;
+        add_usage(&stats.compositions, 1,
+                  arena_alloc_size(sizeof(Composition)) +
+                      arena_alloc_size(sizeof(int) * composition->seat_count));
+    }
+
+    hash_map_iter_begin(network->calendars, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Calendar *calendar = (Calendar *)iter.value;
+        size_t bits = sizeof(unsigned long long) * 8;
+        size_t words = ((size_t)calendar->day_count + bits - 1) / bits;
+        add_usage(&stats.calendars, 1,
+                  arena_alloc_size(sizeof(Calendar)) +
+                      arena_alloc_size(sizeof(unsigned long long) * words));
+    }
+
+    // Interned identifiers
+    size_t id_bytes = sizeof(StringPool);
+    for (StringPoolBlock *block = network->ids->blocks; block != NULL;
+         block = block->next)
+        id_bytes += sizeof(StringPoolBlock) + block->capacity;
+    add_usage(&stats.ids, network->ids->strings.size, id_bytes);
+
+    // Lookup structures
+    HashMap *maps[] = {network->nodes,     network->routes,
+                       network->vehicles,  network->compositions,
+                       network->calendars, &network->ids->strings};
+    for (size_t i = 0; i < sizeof(maps) / sizeof(maps[0]); ++i)
+        add_usage(&stats.hash_maps, maps[i]->size, hash_map_memory(maps[i]));
+    ArrayList *lists[] = {network->node_list, network->route_list,
+                          network->trip_list, network->vehicle_list,
+                          network->service_day_list, network->snapshots,
+                          network->retired};
+    for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); ++i)
+        add_usage(&stats.hash_maps, 0, array_list_memory(lists[i]));
+
+    // Unused bytes of the arena blocks count to the total
+    stats.arena_reserved = network->arena->reserved;
+    stats.arena_allocated = network->arena->allocated;
+    stats.total = sizeof(Network) + sizeof(Arena) +
+                  network->arena->block_count * sizeof(ArenaBlock) +
+                  stats.arena_reserved - stats.arena_allocated;
+    MemoryUsage *categories[] = {
+        &stats.nodes,        &stats.node_routes,      &stats.routes,
+        &stats.stops,        &stats.occupancy,        &stats.trips,
+        &stats.calendars,    &stats.service_days,     &stats.reservations,
+        &stats.vehicles,     &stats.compositions,     &stats.ids,
+        &stats.hash_maps,    &stats.seat_collections, &stats.snapshots};
+    for (size_t i = 0; i < sizeof(categories) / sizeof(categories[0]); ++i)
+        stats.total += categories[i]->bytes;
+
+    return stats;
+}
+
+// Private implementations
+
+static void add_usage(MemoryUsage *usage, size_t count, size_t bytes) {
+    usage->count += count;
+    usage->bytes += bytes;
+}
+
+static size_t array_list_memory(const ArrayList *list) {
+    return sizeof(ArrayList) + sizeof(void *) * list->capacity;
+}
@@ -0,0 +1,289 @@
+/**
+ * @brief Partitioning of networks by route.
+ * @file shard.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "osurs/network.h"
+
+// Private declarations
+
+typedef struct route_weight_t {
+    long weight; /**< Number of stops times trips. */
+    int index;   /**< Route index. */
+} RouteWeight;
+
+static int compare_route_weights(const void *a, const void *b);
+static void balance_routes(Network *network, int shard_count,
+                           int route_shards[]);
+static void build_node_table(NetworkShards *shards);
+static void copy_route(Network *shard, Route *route);
+static void copy_reservations(Trip *trip, Trip *copy, Stop *stops[]);
+static Reservation *copy_reservation(Reservation *res, Trip *trip,
+                                     Stop *stops[]);
+static Node *copy_node(Network *shard, Node *node);
+static Vehicle *copy_vehicle(Network *shard, Vehicle *vehicle);
+static Calendar *copy_calendar(Network *shard, Calendar *calendar);
+
+// Public implementations
+
+NetworkShards *shard_network(Network *network, int shard_count,
+                             const int route_shards[]) {
+    int route_count = (int)network->route_list->size;
+    if (shard_count < 1) return NULL;
+    for (int i = 0; route_shards != NULL && i < route_count; ++i) {
+        if (route_shards[i] < 0 || route_shards[i] >= shard_count)
+            return NULL;
+    }
+
+    NetworkShards *shards = (NetworkShards *)malloc(sizeof(NetworkShards));
+    if (shards == NULL) {
+        perror("Error allocating memory for network shards");
+        exit(1);
+    }
+    shards->network = network;
+    shards->shard_count = shard_count;
+    shards->route_shards = (int *)malloc(sizeof(int) * (route_count + 1));
+    if (route_shards != NULL) {
+        memcpy(shards->route_shards, route_shards, sizeof(int) * route_count);
+    } else {
+        balance_routes(network, shard_count, shards->route_shards);
+    }
+
+    // Copy the routes in the order of their index into their shard
+    shards->shards = (Network **)malloc(sizeof(Network *) * shard_count);
+    for (int s = 0; s < shard_count; ++s) shards->shards[s] = new_network();
+    for (int i = 0; i < route_count; ++i) {
+        copy_route(shards->shards[shards->route_shards[i]],
+                   (Route *)network->route_list->elements[i]);
+    }
+
+    build_node_table(shards);
+    return shards;
+}
+
+int shards_serving(NetworkShards *shards, const Node *orig, const Node *dest,
+                   int result[]) {
+    if (orig->index >= shards->node_count || dest->index >= shards->node_count)
+        return 0;
+
+    // Merge of the sorted shards of both nodes
+    int count = 0;
+    int i = shards->node_shard_start[orig->index];
+    int j = shards->node_shard_start[dest->index];
+    int orig_end = shards->node_shard_start[orig->index + 1];
+    int dest_end = shards->node_shard_start[dest->index + 1];
+    while (i < orig_end && j < dest_end) {
+        int a = shards->node_shards[i];
+        int b = shards->node_shards[j];
+        if (a == b) result[count++] = a;
+        i += a <= b;
+        j += b <= a;
+    }
+    return count;
+}
+
+void delete_network_shards(NetworkShards *shards) {
+    if (shards == NULL) return;
+    for (int s = 0; s < shards->shard_count; ++s)
+        delete_network(shards->shards[s]);
+    free(shards->shards);
+    free(shards->route_shards);
+    free(shards->node_shard_start);
+    free(shards->node_shards);
+    free(shards);
+}
+
+// Private implementations
+
+// Order routes by descending weight, equal weights by index.
+static int compare_route_weights(const void *a, const void *b) {
+    const RouteWeight *route_a = (const RouteWeight *)a;
+    const RouteWeight *route_b = (const RouteWeight *)b;
+    if (route_a->weight != route_b->weight)
+        return route_a->weight < route_b->weight ? 1 : -1;
+    return route_a->index - route_b->index;
+}
+
+// Assign the largest routes first to the shard with the smallest load.
+static void balance_routes(Network *network, int shard_count,
+                           int route_shards[]) {
+    int route_count = (int)network->route_list->size;
+    RouteWeight *weights =
+        (RouteWeight *)malloc(sizeof(RouteWeight) * (route_count + 1));
+    long *loads = (long *)calloc(shard_count, sizeof(long));
+    for (int i = 0; i < route_count; ++i) {
+        Route *route = (Route *)network->route_list->elements[i];
+        weights[i].weight = (long)route->route_size * (long)route->trip_size;
+        weights[i].index = i;
+    }
+    qsort(weights, route_count, sizeof(RouteWeight), compare_route_weights);
+    for (int i = 0; i < route_count; ++i) {
+        int shard = 0;
+        for (int s = 1; s < shard_count; ++s) {
+            if (loads[s] < loads[shard]) shard = s;
+        }
+        loads[shard] += weights[i].weight;
+        route_shards[weights[i].index] = shard;
+    }
+    free(loads);
+    free(weights);
+}
+
+// Collect the shards of the routes passing each node.
+static void build_node_table(NetworkShards *shards) {
+    Network *network = shards->network;
+    int node_count = (int)network->node_list->size;
+    char *serving = (char *)calloc(shards->shard_count, sizeof(char));
+    shards->node_count = node_count;
+    shards->node_shard_start = (int *)malloc(sizeof(int) * (node_count + 1));
+
+    // Count the distinct shards of each node, then fill them in order
+    for (int pass = 0; pass < 2; ++pass) {
+        int count = 0;
+        for (int i = 0; i < node_count; ++i) {
+            Node *node = (Node *)network->node_list->elements[i];
+            for (int r = 0; r < node->route_count; ++r)
+                serving[shards->route_shards[node->route_indices[r]]] = 1;
+            if (pass == 0) shards->node_shard_start[i] = count;
+            for (int s = 0; s < shards->shard_count; ++s) {
+                if (!serving[s]) continue;
+                if (pass == 1) shards->node_shards[count] = s;
+                ++count;
+                serving[s] = 0;
+            }
+        }
+        if (pass == 0) {
+            shards->node_shard_start[node_count] = count;
+            shards->node_shards = (int *)malloc(sizeof(int) * (count + 1));
+        }
+    }
+    free(serving);
+}
+
+// Copy a route with its trips, reservation counts and reservations.
+static void copy_route(Network *shard, Route *route) {
+    size_t route_size = route->route_size;
+    size_t trip_size = route->trip_size;
+    Node **nodes = (Node **)malloc(sizeof(Node *) * route_size);
+    int *arrival_offsets = (int *)malloc(sizeof(int) * route_size);
+    int *departure_offsets = (int *)malloc(sizeof(int) * route_size);
+    const char **trip_ids =
+        (const char **)malloc(sizeof(const char *) * trip_size);
+    int *departures = (int *)malloc(sizeof(int) * trip_size);
+    Vehicle **vehicles = (Vehicle **)malloc(sizeof(Vehicle *) * trip_size);
+    Stop **stops = (Stop **)malloc(sizeof(Stop *) * route_size);
+
+    size_t i = 0;
+    for (Stop *stop = route->root_stop; stop != NULL; stop = stop->next) {
+        nodes[i] = copy_node(shard, stop->node);
+        arrival_offsets[i] = stop->arrival_offset;
+        departure_offsets[i++] = stop->departure_offset;
+    }
+    i = 0;
+    for (Trip *trip = route->root_trip; trip != NULL; trip = trip->next) {
+        trip_ids[i] = trip->id;
+        departures[i] = trip->departure;
+        vehicles[i++] = copy_vehicle(shard, trip->vehicle);
+    }
+    Route *copy = new_route(shard, route->id, nodes, arrival_offsets,
+                            departure_offsets, route_size, trip_ids,
+                            departures, vehicles, trip_size);
+
+    // Reservation counts of the trips, no snapshot shares the new arrays
+    Stop *stop = route->root_stop;
+    i = 0;
+    for (Stop *curr = copy->root_stop; curr != NULL; curr = curr->next) {
+        memcpy(curr->reserved, stop->reserved, sizeof(int) * trip_size);
+        stops[i++] = curr;
+        stop = stop->next;
+    }
+
+    // Reservations, the calendars are set after the booked service days
+    Trip *trip = route->root_trip;
+    for (Trip *curr = copy->root_trip; curr != NULL; curr = curr->next) {
+        copy_reservations(trip, curr, stops);
+        if (trip->calendar != NULL)
+            curr->calendar = copy_calendar(shard, trip->calendar);
+        trip = trip->next;
+    }
+
+    free(stops);
+    free(vehicles);
+    free(departures);
+    free(trip_ids);
+    free(departure_offsets);
+    free(arrival_offsets);
+    free(nodes);
+}
+
+// Copy the undated reservations and the service days of a trip.
+static void copy_reservations(Trip *trip, Trip *copy, Stop *stops[]) {
+    for (size_t i = 0; i < trip->reservations->size; ++i) {
+        Reservation *res = (Reservation *)trip->reservations->elements[i];
+        array_list_add(copy->reservations,
+                       copy_reservation(res, copy, stops));
+        ++copy->version;
+    }
+    for (int d = 0; d < trip->service_day_count; ++d) {
+        ServiceDay *day = trip->service_days[d];
+        ServiceDay *day_copy = new_service_day(copy, day->date);
+        memcpy(day_copy->reserved, day->reserved,
+               sizeof(int) * trip->route->route_size);
+        for (size_t i = 0; i < day->reservations->size; ++i) {
+            Reservation *res = (Reservation *)day->reservations->elements[i];
+            array_list_add(day_copy->reservations,
+                           copy_reservation(res, copy, stops));
+        }
+    }
+}
+
+static Reservation *copy_reservation(Reservation *res, Trip *trip,
+                                     Stop *stops[]) {
+    Reservation *copy = (Reservation *)malloc(sizeof(Reservation));
+    if (copy == NULL) {
+        perror("Error allocating memory for reservation");
+        exit(1);
+    }
+    *copy = *res;
+    copy->trip = trip;
+    copy->orig = stops[res->orig->ordinal];
+    copy->dest = stops[res->dest->ordinal];
+    return copy;
+}
+
+static Node *copy_node(Network *shard, Node *node) {
+    Node *copy = (Node *)hash_map_get(shard->nodes, node->id);
+    if (copy == NULL) copy = new_node(shard, node->id, node->x, node->y);
+    return copy;
+}
+
+static Vehicle *copy_vehicle(Network *shard, Vehicle *vehicle) {
+    Vehicle *copy = (Vehicle *)hash_map_get(shard->vehicles, vehicle->id);
+    if (copy != NULL) return copy;
+    Composition *source = vehicle->composition;
+    Composition *composition =
+        (Composition *)hash_map_get(shard->compositions, source->id);
+    if (composition == NULL) {
+        composition = new_composition(shard, source->id, source->seat_count);
+        memcpy(composition->seat_ids, source->seat_ids,
+               sizeof(int) * source->seat_count);
+    }
+    return new_vehicle(shard, vehicle->id, composition);
+}
+
+static Calendar *copy_calendar(Network *shard, Calendar *calendar) {
+    Calendar *copy = (Calendar *)hash_map_get(shard->calendars, calendar->id);
+    if (copy != NULL) return copy;
+    copy = new_calendar(shard, calendar->id, calendar->first_day,
+                        calendar->day_count);
+    size_t bits = sizeof(unsigned long long) * 8;
+    memcpy(copy->days, calendar->days,
+           sizeof(unsigned long long) *
+               (((size_t)calendar->day_count + bits - 1) / bits));
+    return copy;
+}
@@ -0,0 +1,319 @@
+/**
+ * @brief Copy-on-write snapshots of the reservations of a network.
+ * @file snapshot.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "osurs/network.h"
+
+// Private declarations
+
+static void *snapshot_array(size_t count, size_t size);
+static unsigned long newest_snapshot_epoch(Network *network);
+static int array_shared(Network *network, unsigned long epoch);
+static int page_shared(Network *network, RetiredPage *retired);
+static void retire_page(Network *network, void *page, size_t size,
+                        int in_arena, unsigned long epoch);
+static int *reserved_for_write(Network *network, int **reserved,
+                               unsigned long *reserved_epoch, size_t size);
+static ArrayList *list_for_append(Network *network, ArrayList *list,
+                                  unsigned long *epoch);
+
+// Public implementations
+
+NetworkSnapshot *network_snapshot(Network *network) {
+    NetworkSnapshot *snapshot =
+        (NetworkSnapshot *)malloc(sizeof(NetworkSnapshot));
+    if (snapshot == NULL) {
+        perror("Error allocating memory for network snapshot");
+        exit(1);
+    }
+    pthread_mutex_lock(&network->lock);
+    snapshot->network = network;
+    snapshot->epoch = ++network->epoch;
+
+    // Share the current reserved arrays of all stops
+    snapshot->stop_count = network->stop_count;
+    snapshot->reserved =
+        (int **)snapshot_array(snapshot->stop_count, sizeof(int *));
+    for (size_t i = 0; i < network->route_list->size; ++i) {
+        Route *route = (Route *)network->route_list->elements[i];
+        for (Stop *stop = route->root_stop; stop != NULL; stop = stop->next)
+            snapshot->reserved[stop->index] = stop->reserved;
+    }
+
+    // Share the lists of the trips and service days with their length, since
+    // bookings only append to them or copy them (see list_for_append())
+    int trip_count = (int)network->trip_list->size;
+    snapshot->trip_count = trip_count;
+    snapshot->reservations =
+        (SnapshotList *)snapshot_array(trip_count, sizeof(SnapshotList));
+    snapshot->service_days =
+        (SnapshotList *)snapshot_array(trip_count, sizeof(SnapshotList));
+    for (int i = 0; i < trip_count; ++i) {
+        Trip *trip = (Trip *)network->trip_list->elements[i];
+        snapshot->reservations[i].elements = trip->reservations->elements;
+        snapshot->reservations[i].size = trip->reservations->size;
+        snapshot->service_days[i].elements = (void **)trip->service_days;
+        snapshot->service_days[i].size = (size_t)trip->service_day_count;
+    }
+
+    // The same for the booked service days
+    ArrayList *days = network->service_day_list;
+    snapshot->service_day_count = (int)days->size;
+    snapshot->service_day_reserved =
+        (int **)snapshot_array(snapshot->service_day_count, sizeof(int *));
+    snapshot->day_reservations = (SnapshotList *)snapshot_array(
+        snapshot->service_day_count, sizeof(SnapshotList));
+    for (int i = 0; i < snapshot->service_day_count; ++i) {
+        ServiceDay *day = (ServiceDay *)days->elements[i];
+        snapshot->service_day_reserved[i] = day->reserved;
+        snapshot->day_reservations[i].elements = day->reservations->elements;
+        snapshot->day_reservations[i].size = day->reservations->size;
+    }
+
+    array_list_add(network->snapshots, snapshot);
+    pthread_mutex_unlock(&network->lock);
+    return snapshot;
+}
+
+int snapshot_reserved(NetworkSnapshot *snapshot, Stop *stop, Trip *trip) {
+    if (stop->index >= snapshot->stop_count) return 0;
+    return snapshot->reserved[stop->index][trip->ordinal];
+}
+
+size_t snapshot_reservation_count(NetworkSnapshot *snapshot, Trip *trip) {
+    if (trip->index >= snapshot->trip_count) return 0;
+    return snapshot->reservations[trip->index].size;
+}
+
+Reservation *snapshot_reservation(NetworkSnapshot *snapshot, Trip *trip,
+                                  size_t i) {
+    if (i >= snapshot_reservation_count(snapshot, trip)) return NULL;
+    return (Reservation *)snapshot->reservations[trip->index].elements[i];
+}
+
+int snapshot_service_day_count(NetworkSnapshot *snapshot, Trip *trip) {
+    if (trip->index >= snapshot->trip_count) return 0;
+    return (int)snapshot->service_days[trip->index].size;
+}
+
+ServiceDay *snapshot_service_day(NetworkSnapshot *snapshot, Trip *trip,
+                                 int i) {
+    if (i < 0 || i >= snapshot_service_day_count(snapshot, trip)) return NULL;
+    return (ServiceDay *)snapshot->service_days[trip->index].elements[i];
+}
+
+int snapshot_service_day_reserved(NetworkSnapshot *snapshot, ServiceDay *day,
+                                  Stop *stop) {
+    if (day->index >= snapshot->service_day_count) return 0;
+    return snapshot->service_day_reserved[day->index][stop->ordinal];
+}
+
+size_t snapshot_service_day_reservation_count(NetworkSnapshot *snapshot,
+                                              ServiceDay *day) {
+    if (day->index >= snapshot->service_day_count) return 0;
+    return snapshot->day_reservations[day->index].size;
+}
+
+Reservation *snapshot_service_day_reservation(NetworkSnapshot *snapshot,
+                                              ServiceDay *day, size_t i) {
+    if (i >= snapshot_service_day_reservation_count(snapshot, day))
+        return NULL;
+    return (Reservation *)snapshot->day_reservations[day->index].elements[i];
+}
+
+int *stop_reserved_for_write(Route *route, Stop *stop) {
+    return reserved_for_write(route->network, &stop->reserved,
+                              &stop->reserved_epoch, route->trip_size);
+}
+
+int *service_day_reserved_for_write(ServiceDay *day) {
+    Route *route = day->trip->route;
+    return reserved_for_write(route->network, &day->reserved,
+                              &day->reserved_epoch, route->route_size);
+}
+
+ArrayList *trip_reservations_for_write(Trip *trip) {
+    return list_for_append(trip->route->network, trip->reservations,
+                           &trip->reservations_epoch);
+}
+
+ArrayList *service_day_reservations_for_write(ServiceDay *day) {
+    return list_for_append(day->trip->route->network, day->reservations,
+                           &day->reservations_epoch);
+}
+
+ServiceDay **trip_service_days_for_write(Trip *trip) {
+    Network *network = trip->route->network;
+    int shared = trip->service_days != NULL &&
+                 array_shared(network, trip->service_days_epoch);
+    if (!shared && trip->service_day_count < trip->service_day_capacity)
+        return trip->service_days;
+
+    // Grow the array if full, copy it if a snapshot shares it, since the
+    // service days are inserted sorted by date
+    int capacity = trip->service_day_capacity;
+    if (trip->service_day_count == capacity)
+        capacity = capacity == 0 ? 4 : capacity * 2;
+    ServiceDay **service_days =
+        (ServiceDay **)malloc(sizeof(ServiceDay *) * capacity);
+    if (service_days == NULL) {
+        perror("Error allocating memory for service days");
+        exit(1);
+    }
+    if (trip->service_day_count > 0)
+        memcpy(service_days, trip->service_days,
+               sizeof(ServiceDay *) * trip->service_day_count);
+    if (shared) {
+        retire_page(network, trip->service_days,
+                    sizeof(ServiceDay *) * trip->service_day_capacity, 0,
+                    trip->service_days_epoch);
+    } else {
+        free(trip->service_days);
+    }
+    trip->service_days = service_days;
+    trip->service_day_capacity = capacity;
+    trip->service_days_epoch = network->epoch;
+    return service_days;
+}
+
+void delete_network_snapshot(NetworkSnapshot *snapshot) {
+    if (snapshot == NULL) return;
+    Network *network = snapshot->network;
+
+    // Remove the snapshot from the live snapshots
+    pthread_mutex_lock(&network->lock);
+    ArrayList *snapshots = network->snapshots;
+    for (size_t i = 0; i < snapshots->size; ++i) {
+        if (snapshots->elements[i] == snapshot) {
+            snapshots->elements[i] = snapshots->elements[--snapshots->size];
+            break;
+        }
+    }
+
+    // Release the arrays no live snapshot shares anymore
+    ArrayList *retired = network->retired;
+    size_t kept = 0;
+    for (size_t i = 0; i < retired->size; ++i) {
+        RetiredPage *page = (RetiredPage *)retired->elements[i];
+        if (page_shared(network, page)) {
+            retired->elements[kept++] = page;
+            continue;
+        }
+        if (!page->in_arena) free(page->page);
+        free(page);
+    }
+    retired->size = kept;
+    pthread_mutex_unlock(&network->lock);
+
+    free(snapshot->day_reservations);
+    free(snapshot->service_day_reserved);
+    free(snapshot->service_days);
+    free(snapshot->reservations);
+    free(snapshot->reserved);
+    free(snapshot);
+}
+
+// Private implementations
+
+// Allocate an array of a snapshot with an entry after the last.
+static void *snapshot_array(size_t count, size_t size) {
+    void *array = malloc(size * (count + 1));
+    if (array == NULL) {
+        perror("Error allocating memory for network snapshot");
+        exit(1);
+    }
+    return array;
+}
+
+static unsigned long newest_snapshot_epoch(Network *network) {
+    unsigned long epoch = 0;
+    for (size_t i = 0; i < network->snapshots->size; ++i) {
+        NetworkSnapshot *snapshot =
+            (NetworkSnapshot *)network->snapshots->elements[i];
+        if (snapshot->epoch > epoch) epoch = snapshot->epoch;
+    }
+    return epoch;
+}
+
+// An array created in the epoch is shared by the snapshots taken after.
+static int array_shared(Network *network, unsigned long epoch) {
+    return network->snapshots->size > 0 &&
+           newest_snapshot_epoch(network) > epoch;
+}
+
+// A retired array is shared by the snapshots taken while it was current.
+static int page_shared(Network *network, RetiredPage *retired) {
+    for (size_t i = 0; i < network->snapshots->size; ++i) {
+        NetworkSnapshot *snapshot =
+            (NetworkSnapshot *)network->snapshots->elements[i];
+        if (snapshot->epoch > retired->epoch &&
+            snapshot->epoch <= retired->until)
+            return 1;
+    }
+    return 0;
+}
+
+// Keep an array replaced while shared until no snapshot shares it anymore.
+static void retire_page(Network *network, void *page, size_t size,
+                        int in_arena, unsigned long epoch) {
+    RetiredPage *retired = (RetiredPage *)malloc(sizeof(RetiredPage));
+    if (retired == NULL) {
+        perror("Error allocating memory for retired array");
+        exit(1);
+    }
+    retired->page = page;
+    retired->size = size;
+    retired->in_arena = in_arena;
+    retired->epoch = epoch;
+    retired->until = network->epoch;
+    array_list_add(network->retired, retired);
+}
+
+// Copy a reserved array shared with a snapshot and retire the shared one,
+// called by the bookings, which hold the lock of the network.
+static int *reserved_for_write(Network *network, int **reserved,
+                               unsigned long *reserved_epoch, size_t size) {
+    // Write in place if no snapshot shares the array
+    if (!array_shared(network, *reserved_epoch)) return *reserved;
+
+    // Copy the array and keep the shared one for the snapshots, the original
+    // arrays are located in the arena
+    int *page = (int *)malloc(sizeof(int) * size);
+    if (page == NULL) {
+        perror("Error allocating memory for reserved array");
+        exit(1);
+    }
+    memcpy(page, *reserved, sizeof(int) * size);
+    retire_page(network, *reserved, sizeof(int) * size, *reserved_epoch == 0,
+                *reserved_epoch);
+    *reserved = page;
+    *reserved_epoch = network->epoch;
+    return page;
+}
+
+// Make room to append to a list shared with a snapshot: appending behind the
+// shared length is safe, only a full array, which would be moved, is copied.
+static ArrayList *list_for_append(Network *network, ArrayList *list,
+                                  unsigned long *epoch) {
+    if (list->size < list->capacity || !array_shared(network, *epoch))
+        return list;
+    size_t capacity = list->capacity * 2;
+    void **elements = (void **)malloc(sizeof(void *) * capacity);
+    if (elements == NULL) {
+        perror("Error allocating memory for reservation list");
+        exit(1);
+    }
+    memcpy(elements, list->elements, sizeof(void *) * list->size);
+    retire_page(network, list->elements, sizeof(void *) * list->capacity, 0,
+                *epoch);
+    list->elements = elements;
+    list->capacity = capacity;
+    *epoch = network->epoch;
+    return list;
+}
@@ -1,80 +1,342 @@
-/**
- * @brief Optimization logic abstraction layer.
- * @file olal.c
- * @date: 2022-09-30
- * @author: Tobias Meier
- */
-
-#include "osurs/olal.h"
-
-// optimizes the seat reservations on the given trip
-SeatCollection* optimize_trip(Trip* t) {
-    // get first stop of the route
-    Stop* current_stop = t->route->root_stop;
-    // create a temporary array to store the logical representation of the
-    // reservations
-    unsigned int* temp_logical_res_arr =
-        (unsigned int*)malloc(sizeof(unsigned int) * t->reservations->size);
-    for (int i = 0; i < t->reservations->size; ++i) {
-        temp_logical_res_arr[i] = 0;
-    }
-    // iterate over each stop in the route
-    for (int i = 0; i < t->route->route_size; ++i) {
-        // iterate over each seat in the reservation
-        for (int j = 0; j < t->reservations->size; ++j) {
-            // check if it is the first stop of the route
-            if (i > 0) {
-                // if (the current stop equals to the res-origin) or (the last
-                // stop was reserved and the current stop does not equal to the
-                // res-dest) then set the bit to 1
-                if ((((Reservation*)t->reservations->elements[j])->orig ==
-                     current_stop) ||
-                    ((temp_logical_res_arr[j] & (1u << (i - 1))) &&
-                     (current_stop !=
-                      ((Reservation*)t->reservations->elements[j])->dest))) {
-                    temp_logical_res_arr[j] |= (1u << i);
-                }
-            } else {
-                // if the fist stop matches the reservation origin then set the
-                // bit to 1
-                if (((Reservation*)t->reservations->elements[j])->orig ==
-                    current_stop) {
-                    temp_logical_res_arr[j] |= 1u;
-                }
-            }
-        }
-        current_stop = current_stop->next;
-    }
-
-    // count the total number of seat reservations
-    int used_seat_count = 0;
-    for (int i = 0; i < t->reservations->size; ++i) {
-        used_seat_count += ((Reservation*)t->reservations->elements[i])->seats;
-    }
-
-    // reshape the logical representation array and create the res_id array
-    int* res_ids = (int*)malloc(sizeof(int) * used_seat_count);
-    unsigned int* logical_res_arr =
-        (unsigned int*)malloc(sizeof(unsigned int) * used_seat_count);
-    int seat_pos = 0;
-    for (int i = 0; i < t->reservations->size; ++i) {
-        for (int j = 0; j < ((Reservation*)t->reservations->elements[i])->seats;
-             ++j) {
-            logical_res_arr[seat_pos] = temp_logical_res_arr[i];
-            res_ids[seat_pos++] =
-                ((Reservation*)t->reservations->elements[i])->res_id;
-        }
-    }
-
-    // call the optimization method
-    SeatCollection* result = optimize_reservation(
-        logical_res_arr, t->reservations->size, res_ids,
-        (int)t->route->route_size - 1, t->vehicle->composition->seat_ids,
-        t->vehicle->composition->seat_count);
-
-    free(res_ids);
-    free(temp_logical_res_arr);
-    free(logical_res_arr);
-
-    return result;
-}
\ No newline at end of file
+/**
+ * @brief Optimization logic abstraction layer.
+ * @file olal.c
+ * @date: 2022-09-30
+ * @author: Tobias Meier
+ */
+
+#include "osurs/olal.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "pool.h"
+
+// Private declarations
+
+typedef struct network_task_t {
+    NetworkOptimization* result;
+    OptimizeStrategy strategy;
+    OptimizeWorkspace** workspaces; /**< One workspace per worker. */
+} NetworkTask;
+
+/** The maximum number of segments a trip can have to be optimized. */
+#define MAX_SEGMENTS ((int)sizeof(unsigned long long) * 8)
+
+/** Releases and measures the results cached on the trips of a network. */
+static const TripCacheOps seat_collection_cache_ops = {
+    delete_seat_collection, seat_collection_memory};
+
+static void trip_segment_masks(ArrayList* reservations,
+                               unsigned long long res_masks[]);
+static unsigned long long segment_range_mask(int orig, int dest);
+static int trip_seat_count(ArrayList* reservations);
+static void trip_seat_masks(ArrayList* reservations,
+                            unsigned long long res_masks[],
+                            unsigned long long seat_masks[]);
+static void trip_res_ids(ArrayList* reservations, int res_ids[]);
+static int trip_prepare(OptimizeWorkspace* workspace, Trip* t,
+                        ArrayList* reservations);
+static SeatCollection* optimize_reservations_in(OptimizeWorkspace* workspace,
+                                                Trip* t,
+                                                ArrayList* reservations,
+                                                OptimizeStrategy strategy);
+static SeatCollection* reoptimize_reservations(Trip* t,
+                                               ArrayList* reservations,
+                                               SeatCollection* previous);
+static void optimize_network_task(void* context, int worker, size_t index);
+
+// Public definitions
+
+// optimizes the seat reservations on the given trip
+SeatCollection* optimize_trip(Trip* t) {
+    return optimize_trip_with(t, OPTIMIZE_SPARSEST);
+}
+
+SeatCollection* optimize_trip_with(Trip* t, OptimizeStrategy strategy) {
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    SeatCollection* result = optimize_trip_in(workspace, t, strategy);
+    if (result != NULL) result = optimize_workspace_detach(workspace);
+    delete_optimize_workspace(workspace);
+    return result;
+}
+
+SeatCollection* optimize_trip_cached(Trip* t, OptimizeStrategy strategy) {
+    if (t->cache_strategy == (int)strategy && t->cache_version == t->version)
+        return t->cache;
+
+    // the reservations or the strategy changed since the cached result
+    if (t->cache != NULL) delete_seat_collection(t->cache);
+    t->route->network->cache_ops = &seat_collection_cache_ops;
+    t->cache = optimize_trip_with(t, strategy);
+    t->cache_version = t->version;
+    t->cache_strategy = strategy;
+    return t->cache;
+}
+
+SeatCollection* optimize_trip_in(OptimizeWorkspace* workspace, Trip* t,
+                                 OptimizeStrategy strategy) {
+    return optimize_reservations_in(workspace, t, t->reservations, strategy);
+}
+
+SeatCollection* optimize_service_day(ServiceDay* day,
+                                     OptimizeStrategy strategy) {
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    SeatCollection* result = optimize_reservations_in(
+        workspace, day->trip, day->reservations, strategy);
+    if (result != NULL) result = optimize_workspace_detach(workspace);
+    delete_optimize_workspace(workspace);
+    return result;
+}
+
+SeatCollection* optimize_trip_anytime(Trip* t, long deadline_us) {
+    int segment_count = (int)t->route->route_size - 1;
+    if (segment_count > MAX_SEGMENTS) return NULL;
+
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    int used_seat_count = trip_prepare(workspace, t, t->reservations);
+
+    Composition* composition = t->vehicle->composition;
+    SeatCollection* result = optimize_reservation_anytime(
+        workspace->masks, used_seat_count, workspace->res_ids, segment_count,
+        composition->seat_ids, composition->seat_count, deadline_us);
+    delete_optimize_workspace(workspace);
+
+    if (result != NULL) {
+        result->res_covered = t->reservations->size;
+        result->res_source = t->reservations;
+    }
+    return result;
+}
+
+SeatCollection* reoptimize_trip(Trip* t, SeatCollection* previous) {
+    if (previous == NULL) return optimize_trip_with(t, OPTIMIZE_GROUP_ADJACENT);
+    SeatCollection* result =
+        reoptimize_reservations(t, t->reservations, previous);
+
+    // the cached collection covers the new reservations now, keep it valid
+    if (result != NULL && result == t->cache) t->cache_version = t->version;
+    return result;
+}
+
+SeatCollection* reoptimize_service_day(ServiceDay* day,
+                                       SeatCollection* previous) {
+    if (previous == NULL)
+        return optimize_service_day(day, OPTIMIZE_GROUP_ADJACENT);
+    return reoptimize_reservations(day->trip, day->reservations, previous);
+}
+
+NetworkOptimization* optimize_network(Network* network,
+                                      OptimizeStrategy strategy, int threads) {
+    return optimize_network_window(network, INT_MIN, INT_MAX, strategy,
+                                   threads);
+}
+
+NetworkOptimization* optimize_network_window(Network* network, int from,
+                                             int to, OptimizeStrategy strategy,
+                                             int threads) {
+    NetworkOptimization* result =
+        (NetworkOptimization*)malloc(sizeof(NetworkOptimization));
+    result->size = 0;
+
+    // Count the trips in the departure window
+    HashMapIterator iter;
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Trip* trip = ((Route*)iter.value)->root_trip;
+        while (trip != NULL) {
+            if (trip->departure >= from && trip->departure < to)
+                ++result->size;
+            trip = trip->next;
+        }
+    }
+
+    // Collect the trips into the flat result array
+    result->trips = (Trip**)malloc(sizeof(Trip*) * result->size);
+    result->collections =
+        (SeatCollection**)calloc(result->size, sizeof(SeatCollection*));
+    size_t count = 0;
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Trip* trip = ((Route*)iter.value)->root_trip;
+        while (trip != NULL) {
+            if (trip->departure >= from && trip->departure < to)
+                result->trips[count++] = trip;
+            trip = trip->next;
+        }
+    }
+
+    // Optimize on the work-stealing pool with a workspace per worker
+    int workers = threads > 1 ? threads : 1;
+    OptimizeWorkspace** workspaces =
+        (OptimizeWorkspace**)malloc(sizeof(OptimizeWorkspace*) * workers);
+    for (int i = 0; i < workers; ++i) workspaces[i] = new_optimize_workspace();
+    NetworkTask task = {result, strategy, workspaces};
+    result->threads =
+        pool_run(result->size, threads, optimize_network_task, &task);
+    for (int i = 0; i < workers; ++i) delete_optimize_workspace(workspaces[i]);
+    free(workspaces);
+
+    return result;
+}
+
+void delete_network_optimization(NetworkOptimization* result) {
+    if (result == NULL) return;
+    for (size_t i = 0; i < result->size; ++i) {
+        if (result->collections[i] != NULL)
+            delete_seat_collection(result->collections[i]);
+    }
+    free(result->collections);
+    free(result->trips);
+    free(result);
+}
+
+// Private definitions
+
+// Optimize reservations of a trip (undated or of a service day).
+static SeatCollection* optimize_reservations_in(OptimizeWorkspace* workspace,
+                                                Trip* t,
+                                                ArrayList* reservations,
+                                                OptimizeStrategy strategy) {
+    int segment_count = (int)t->route->route_size - 1;
+    if (segment_count > MAX_SEGMENTS) return NULL;
+
+    // logical representation of the reservations, one entry per reserved seat
+    int used_seat_count = trip_prepare(workspace, t, reservations);
+
+    // call the optimization kernel specialized for the mask width
+    Composition* composition = t->vehicle->composition;
+    SeatCollection* result = optimize_reservation_in(
+        workspace, strategy, workspace->masks, used_seat_count,
+        workspace->res_ids, segment_count, composition->seat_ids,
+        composition->seat_count);
+
+    if (result != NULL) {
+        result->res_covered = reservations->size;
+        result->res_source = reservations;
+    }
+    return result;
+}
+
+// Place the reservations added since the previous collection was optimized.
+static SeatCollection* reoptimize_reservations(Trip* t,
+                                               ArrayList* reservations,
+                                               SeatCollection* previous) {
+    if ((int)t->route->route_size - 1 > MAX_SEGMENTS) return NULL;
+    // the covered reservations only count in the list they were taken from
+    if (previous->res_source != reservations) return NULL;
+
+    // only the reservations added since the previous optimization are placed,
+    // the seats of the existing reservations stay fixed
+    for (int j = previous->res_covered; j < reservations->size; ++j) {
+        Reservation* res = (Reservation*)reservations->elements[j];
+        unsigned long long mask =
+            segment_range_mask(res->orig->ordinal, res->dest->ordinal);
+
+        // search a window of adjacent seats free along the segments
+        int start = -1;
+        int run = 0;
+        for (int i = 0; i < previous->seat_count; ++i) {
+            run = (previous->segments[i] & mask) == 0 ? run + 1 : 0;
+            if (run == res->seats) {
+                start = i - res->seats + 1;
+                break;
+            }
+        }
+
+        // place the seats side by side or on the first free seats
+        int next = 0;
+        for (int k = 0; k < res->seats; ++k) {
+            int seat = -1;
+            if (start >= 0) {
+                seat = start + k;
+            } else {
+                for (; next < previous->seat_count; ++next) {
+                    if ((previous->segments[next] & mask) == 0) {
+                        seat = next++;
+                        break;
+                    }
+                }
+            }
+            if (seat < 0) {
+                ++previous->quality.unplaced;
+                continue;
+            }
+            previous->segments[seat] |= mask;
+            seat_add_reservation(previous->seat_arr[seat], res->res_id);
+        }
+    }
+    previous->res_covered = reservations->size;
+    seat_collection_build_index(previous);
+    return previous;
+}
+
+// Fill the reserved seat arrays of the workspace, return the reserved seats.
+static int trip_prepare(OptimizeWorkspace* workspace, Trip* t,
+                        ArrayList* reservations) {
+    int used_seat_count = trip_seat_count(reservations);
+    optimize_workspace_reserve(workspace, reservations->size, used_seat_count,
+                               t->vehicle->composition->seat_count);
+    trip_segment_masks(reservations, workspace->trip_masks);
+    trip_seat_masks(reservations, workspace->trip_masks, workspace->masks);
+    trip_res_ids(reservations, workspace->res_ids);
+    return used_seat_count;
+}
+
+// Repeat the mask of each reservation for each of its reserved seats.
+static void trip_seat_masks(ArrayList* reservations,
+                            unsigned long long res_masks[],
+                            unsigned long long seat_masks[]) {
+    int seat_pos = 0;
+    for (int i = 0; i < reservations->size; ++i) {
+        Reservation* res = (Reservation*)reservations->elements[i];
+        for (int j = 0; j < res->seats; ++j)
+            seat_masks[seat_pos++] = res_masks[i];
+    }
+}
+
+// Create the reservation id of each reserved seat.
+static void trip_res_ids(ArrayList* reservations, int res_ids[]) {
+    int seat_pos = 0;
+    for (int i = 0; i < reservations->size; ++i) {
+        Reservation* res = (Reservation*)reservations->elements[i];
+        for (int j = 0; j < res->seats; ++j) res_ids[seat_pos++] = res->res_id;
+    }
+}
+
+// Optimize a single trip of a network optimization.
+static void optimize_network_task(void* context, int worker, size_t index) {
+    NetworkTask* task = (NetworkTask*)context;
+    OptimizeWorkspace* workspace = task->workspaces[worker];
+    // the result keeps the collection, the scratch buffers are reused
+    if (optimize_trip_in(workspace, task->result->trips[index],
+                         task->strategy) != NULL)
+        task->result->collections[index] = optimize_workspace_detach(workspace);
+}
+
+// Create the logical representation (segment mask) of each reservation.
+static void trip_segment_masks(ArrayList* reservations,
+                               unsigned long long res_masks[]) {
+    void** elements = reservations->elements;
+    int size = reservations->size;
+    for (int j = 0; j < size; ++j) {
+        Reservation* res = (Reservation*)elements[j];
+        res_masks[j] = segment_range_mask(res->orig->ordinal,
+                                          res->dest->ordinal);
+    }
+}
+
+// Mask of the segments from the orig stop up to the dest stop (excluded).
+static unsigned long long segment_range_mask(int orig, int dest) {
+    // branch free: dest - orig is in [1, 64], so both shifts are defined
+    return (~0ull >> (MAX_SEGMENTS - (dest - orig))) << orig;
+}
+
+// Count the total number of seat reservations.
+static int trip_seat_count(ArrayList* reservations) {
+    int used_seat_count = 0;
+    for (int i = 0; i < reservations->size; ++i) {
+        used_seat_count += ((Reservation*)reservations->elements[i])->seats;
+    }
+    return used_seat_count;
+}
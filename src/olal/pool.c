@@ -0,0 +1,245 @@
+/**
+ * @brief Work-stealing thread pool.
+ * @file pool.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Private declarations
+
+typedef struct deque_t {
+    pthread_mutex_t lock;
+    size_t *tasks; /**< Task indices of the deque. */
+    size_t front;  /**< Index of the first task (stealing end). */
+    size_t back;   /**< Index after the last task (owner end). */
+} Deque;
+
+struct pool_t {
+    Deque *deques;
+    int workers;
+    PoolTask task;
+    void *context;
+    size_t *tasks;         /**< Task indices shared by the deques. */
+    size_t task_capacity;  /**< Capacity of the task index array. */
+    pthread_t *handles;    /**< Worker threads, the first is the caller. */
+    struct worker_t *args; /**< Arguments of the workers. */
+    pthread_mutex_t lock;  /**< Protects the fields below. */
+    pthread_cond_t start;  /**< Signals a new batch or the shutdown. */
+    pthread_cond_t done;   /**< Signals the end of a batch. */
+    unsigned long batch;   /**< Number of the current batch. */
+    int running;           /**< Worker threads still in the batch. */
+    int stop;              /**< Set to shut the workers down. */
+};
+
+typedef struct worker_t {
+    Pool *pool;
+    int index;
+} Worker;
+
+static int deque_pop(Deque *deque, size_t *task);
+static int deque_steal(Deque *victim, Deque *thief);
+static void *worker_run(void *arg);
+static void *worker_loop(void *arg);
+
+// Public definitions
+
+Pool *pool_create(int threads) {
+    Pool *pool = (Pool *)malloc(sizeof(Pool));
+    if (pool == NULL) {
+        perror("Error allocating memory for pool");
+        exit(1);
+    }
+    pool->workers = threads > 1 ? threads : 1;
+    pool->deques = (Deque *)malloc(sizeof(Deque) * pool->workers);
+    pool->handles = (pthread_t *)malloc(sizeof(pthread_t) * pool->workers);
+    pool->args = (Worker *)malloc(sizeof(Worker) * pool->workers);
+    if (pool->deques == NULL || pool->handles == NULL || pool->args == NULL) {
+        perror("Error allocating memory for pool workers");
+        exit(1);
+    }
+    pool->task = NULL;
+    pool->context = NULL;
+    pool->tasks = NULL;
+    pool->task_capacity = 0;
+    pool->batch = 0;
+    pool->running = 0;
+    pool->stop = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (int w = 0; w < pool->workers; ++w) {
+        pthread_mutex_init(&pool->deques[w].lock, NULL);
+        pool->deques[w].front = 0;
+        pool->deques[w].back = 0;
+        pool->args[w].pool = pool;
+        pool->args[w].index = w;
+    }
+
+    // The calling thread is the first worker, the others wait for batches
+    for (int w = 1; w < pool->workers; ++w) {
+        if (pthread_create(&pool->handles[w], NULL, worker_loop,
+                           &pool->args[w]) != 0) {
+            perror("Error creating pool worker thread");
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+void pool_execute(Pool *pool, size_t task_count, PoolTask task,
+                  void *context) {
+    if (pool->workers < 2 || task_count < 2) {
+        for (size_t i = 0; i < task_count; ++i) task(context, 0, i);
+        return;
+    }
+
+    // Distribute the tasks in contiguous blocks over the deques
+    if (task_count > pool->task_capacity) {
+        free(pool->tasks);
+        pool->tasks = (size_t *)malloc(sizeof(size_t) * task_count);
+        if (pool->tasks == NULL) {
+            perror("Error allocating memory for pool tasks");
+            exit(1);
+        }
+        pool->task_capacity = task_count;
+    }
+    for (size_t i = 0; i < task_count; ++i) pool->tasks[i] = i;
+    for (int w = 0; w < pool->workers; ++w) {
+        Deque *deque = &pool->deques[w];
+        deque->tasks = pool->tasks;
+        deque->front = task_count * w / pool->workers;
+        deque->back = task_count * (w + 1) / pool->workers;
+    }
+    pool->task = task;
+    pool->context = context;
+
+    // Start the batch, work on it and wait for the other workers
+    pthread_mutex_lock(&pool->lock);
+    pool->running = pool->workers - 1;
+    ++pool->batch;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    worker_run(&pool->args[0]);
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_free(Pool *pool) {
+    if (pool == NULL) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int w = 1; w < pool->workers; ++w)
+        pthread_join(pool->handles[w], NULL);
+
+    for (int w = 0; w < pool->workers; ++w)
+        pthread_mutex_destroy(&pool->deques[w].lock);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->tasks);
+    free(pool->args);
+    free(pool->handles);
+    free(pool->deques);
+    free(pool);
+}
+
+int pool_run(size_t task_count, int threads, PoolTask task, void *context) {
+    if (threads > (int)task_count) threads = (int)task_count;
+    if (threads < 2) {
+        for (size_t i = 0; i < task_count; ++i) task(context, 0, i);
+        return 1;
+    }
+    Pool *pool = pool_create(threads);
+    pool_execute(pool, task_count, task, context);
+    pool_free(pool);
+    return threads;
+}
+
+// Private definitions
+
+// Take a task from the back of the own deque.
+static int deque_pop(Deque *deque, size_t *task) {
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->back > deque->front) {
+        *task = deque->tasks[--deque->back];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Move the front half of the victim's tasks to the empty deque of the thief.
+static int deque_steal(Deque *victim, Deque *thief) {
+    size_t front, back;
+    pthread_mutex_lock(&victim->lock);
+    size_t available = victim->back - victim->front;
+    if (available == 0) {
+        pthread_mutex_unlock(&victim->lock);
+        return 0;
+    }
+    front = victim->front;
+    back = front + (available + 1) / 2;
+    victim->front = back;
+    pthread_mutex_unlock(&victim->lock);
+
+    // Stolen ranges are still part of the shared task index array
+    pthread_mutex_lock(&thief->lock);
+    thief->front = front;
+    thief->back = back;
+    pthread_mutex_unlock(&thief->lock);
+    return 1;
+}
+
+static void *worker_run(void *arg) {
+    Worker *worker = (Worker *)arg;
+    Pool *pool = worker->pool;
+    Deque *own = &pool->deques[worker->index];
+    size_t task;
+
+    while (1) {
+        while (deque_pop(own, &task)) {
+            pool->task(pool->context, worker->index, task);
+        }
+        // Own deque is empty, try to steal from the other workers
+        int stolen = 0;
+        for (int i = 1; i < pool->workers && !stolen; ++i) {
+            Deque *victim = &pool->deques[(worker->index + i) % pool->workers];
+            stolen = deque_steal(victim, own);
+        }
+        if (!stolen) break;
+    }
+    return NULL;
+}
+
+// Wait for batches until the pool is freed.
+static void *worker_loop(void *arg) {
+    Worker *worker = (Worker *)arg;
+    Pool *pool = worker->pool;
+    unsigned long batch = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->batch == batch)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) break;
+        batch = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+
+        worker_run(worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
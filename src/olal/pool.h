@@ -0,0 +1,76 @@
+/**
+ * @brief Work-stealing thread pool.
+ * @file pool.h
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#ifndef OSURS_OLAL_POOL_H_
+#define OSURS_OLAL_POOL_H_
+
+#include <stddef.h>
+
+/**
+ * @brief A task of the pool.
+ *
+ * @param context The context passed to pool_run().
+ * @param worker The index of the worker executing the task.
+ * @param index The index of the task.
+ */
+typedef void (*PoolTask)(void *context, int worker, size_t index);
+
+/**
+ * @brief A work-stealing thread pool with persistent worker threads.
+ */
+typedef struct pool_t Pool;
+
+/**
+ * @brief Create a thread pool.
+ *
+ * Starts the worker threads, which wait for batches of tasks until the pool is
+ * freed. The thread calling pool_execute() is the first worker.
+ *
+ * @param threads The number of workers including the calling thread.
+ * @return A pointer to the pool, to be released with pool_free().
+ */
+Pool *pool_create(int threads);
+
+/**
+ * @brief Execute a batch of tasks on a thread pool.
+ *
+ * Distributes the tasks over the workers like pool_run() and returns after
+ * all tasks have been executed. Batches of a pool must not overlap.
+ *
+ * @param pool The pool.
+ * @param task_count The number of tasks, indexed from 0 to task_count - 1.
+ * @param task The task function.
+ * @param context The context passed to each task.
+ */
+void pool_execute(Pool *pool, size_t task_count, PoolTask task, void *context);
+
+/**
+ * @brief Stop the worker threads and free a thread pool.
+ *
+ * @param pool The pool to free.
+ */
+void pool_free(Pool *pool);
+
+/**
+ * @brief Run tasks on a work-stealing thread pool.
+ *
+ * The task indices are distributed in contiguous blocks over the deques of the
+ * workers. Each worker takes tasks from the back of its own deque and, if it
+ * runs empty, steals half of the remaining tasks from the front of the deque
+ * of another worker. The call returns after all tasks have been executed.
+ * The worker threads only live for the call, pool_create() keeps them.
+ *
+ * @param task_count The number of tasks, indexed from 0 to task_count - 1.
+ * @param threads The number of worker threads; values below 2 execute all
+ * tasks on the calling thread.
+ * @param task The task function.
+ * @param context The context passed to each task.
+ * @return The number of workers used.
+ */
+int pool_run(size_t task_count, int threads, PoolTask task, void *context);
+
+#endif  // OSURS_OLAL_POOL_H_
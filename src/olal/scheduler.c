@@ -0,0 +1,185 @@
+/**
+ * @brief Departure-driven optimization scheduler.
+ * @file scheduler.c
+ * @date: 2026-10-18
+ * @author: Merlin Unterfinger
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "osurs/olal.h"
+#include "pool.h"
+
+// Private declarations
+
+typedef struct scheduler_batch_t {
+    Scheduler* scheduler;
+    Trip** trips;
+    SeatCollection** collections;
+} SchedulerBatch;
+
+static int trip_due(Scheduler* scheduler, Trip* trip);
+static int wall_clock_now(void* context);
+static void wall_clock_sleep(void* context, int seconds);
+static void scheduler_task(void* context, int worker, size_t index);
+
+// Public definitions
+
+Scheduler* new_scheduler(Network* network, int lead_time,
+                         OptimizeStrategy strategy, int threads) {
+    Scheduler* scheduler = (Scheduler*)malloc(sizeof(Scheduler));
+    if (scheduler == NULL) {
+        perror("Error allocating memory for scheduler");
+        exit(1);
+    }
+    scheduler->queue = priority_queue_create();
+    scheduler->lead_time = lead_time;
+    scheduler->strategy = strategy;
+    scheduler->threads = threads > 1 ? threads : 1;
+    scheduler->pool = pool_create(scheduler->threads);
+    scheduler->workspaces = (OptimizeWorkspace**)malloc(
+        sizeof(OptimizeWorkspace*) * scheduler->threads);
+    if (scheduler->workspaces == NULL) {
+        perror("Error allocating memory for scheduler workspaces");
+        exit(1);
+    }
+    for (int i = 0; i < scheduler->threads; ++i)
+        scheduler->workspaces[i] = new_optimize_workspace();
+
+    // The wall clock counts from the midnight of the service day on
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    scheduler->midnight = mktime(&local);
+    scheduler->clock.now = wall_clock_now;
+    scheduler->clock.sleep = wall_clock_sleep;
+    scheduler->clock.context = scheduler;
+    scheduler->callback = NULL;
+    scheduler->callback_context = NULL;
+    scheduler->optimized = 0;
+
+    // Queue all trips by the time they are due
+    HashMapIterator iter;
+    hash_map_iter_begin(network->routes, &iter);
+    while (hash_map_iter_next(&iter)) {
+        Trip* trip = ((Route*)iter.value)->root_trip;
+        while (trip != NULL) {
+            priority_queue_add(scheduler->queue, trip_due(scheduler, trip),
+                               trip);
+            trip = trip->next;
+        }
+    }
+
+    return scheduler;
+}
+
+void scheduler_set_clock(Scheduler* scheduler, SchedulerClock clock) {
+    scheduler->clock = clock;
+}
+
+void scheduler_set_callback(Scheduler* scheduler, SchedulerCallback callback,
+                            void* context) {
+    scheduler->callback = callback;
+    scheduler->callback_context = context;
+}
+
+int scheduler_next_due(Scheduler* scheduler) {
+    Trip* trip = (Trip*)priority_queue_peek(scheduler->queue);
+    if (trip == NULL) return INT_MAX;
+    return trip_due(scheduler, trip);
+}
+
+size_t scheduler_run_due(Scheduler* scheduler) {
+    int now = scheduler->clock.now(scheduler->clock.context);
+
+    // Take all due trips from the queue, in the order of their departures
+    size_t size = 0;
+    size_t capacity = 0;
+    Trip** trips = NULL;
+    while (scheduler_next_due(scheduler) <= now) {
+        if (size == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 16;
+            trips = (Trip**)realloc(trips, sizeof(Trip*) * capacity);
+        }
+        trips[size++] = (Trip*)priority_queue_poll(scheduler->queue);
+    }
+    if (size == 0) return 0;
+
+    // Optimize on the work-stealing pool
+    SchedulerBatch batch = {scheduler, trips,
+                            (SeatCollection**)calloc(size,
+                                                     sizeof(SeatCollection*))};
+    pool_execute(scheduler->pool, size, scheduler_task, &batch);
+
+    // Hand the results over on the calling thread
+    for (size_t i = 0; i < size; ++i) {
+        if (scheduler->callback != NULL) {
+            scheduler->callback(trips[i], batch.collections[i],
+                                scheduler->callback_context);
+        } else if (batch.collections[i] != NULL) {
+            delete_seat_collection(batch.collections[i]);
+        }
+    }
+    scheduler->optimized += size;
+
+    free(batch.collections);
+    free(trips);
+    return size;
+}
+
+size_t scheduler_run(Scheduler* scheduler) {
+    size_t optimized = 0;
+    while (scheduler_next_due(scheduler) != INT_MAX) {
+        int wait = scheduler_next_due(scheduler) -
+                   scheduler->clock.now(scheduler->clock.context);
+        if (wait > 0) scheduler->clock.sleep(scheduler->clock.context, wait);
+        optimized += scheduler_run_due(scheduler);
+    }
+    return optimized;
+}
+
+void delete_scheduler(Scheduler* scheduler) {
+    if (scheduler == NULL) return;
+    pool_free(scheduler->pool);
+    for (int i = 0; i < scheduler->threads; ++i)
+        delete_optimize_workspace(scheduler->workspaces[i]);
+    free(scheduler->workspaces);
+    priority_queue_free(scheduler->queue);
+    free(scheduler);
+}
+
+// Private definitions
+
+// Trips departing within the lead time after midnight are due at midnight.
+static int trip_due(Scheduler* scheduler, Trip* trip) {
+    int due = trip->departure - scheduler->lead_time;
+    return due > 0 ? due : 0;
+}
+
+// Seconds since the midnight of the service day, continues after 24:00.
+static int wall_clock_now(void* context) {
+    Scheduler* scheduler = (Scheduler*)context;
+    return (int)difftime(time(NULL), scheduler->midnight);
+}
+
+// Wait on the calling thread.
+static void wall_clock_sleep(void* context, int seconds) {
+    (void)context;
+    sleep(seconds);
+}
+
+// Optimize a single trip of a batch.
+static void scheduler_task(void* context, int worker, size_t index) {
+    SchedulerBatch* batch = (SchedulerBatch*)context;
+    Scheduler* scheduler = batch->scheduler;
+    OptimizeWorkspace* workspace = scheduler->workspaces[worker];
+    if (optimize_trip_in(workspace, batch->trips[index], scheduler->strategy) !=
+        NULL)
+        batch->collections[index] = optimize_workspace_detach(workspace);
+}
@@ -0,0 +1,323 @@
+/**
+ * @brief Anytime seat optimization for group reservations.
+ * @file anytime.c
+ * @date: 2026-10-18
+ * @author: Tobias Meier, Merlin Unterfinger
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "osurs/optimize.h"
+
+// Private declarations
+
+/** Seed of the random number generator of the local search. */
+#define SOLVER_SEED 42u
+
+typedef struct solver_t {
+    unsigned long long *res_arr;    /**< Segment mask of each reserved seat. */
+    int res_count;                  /**< Number of reserved seats. */
+    int seat_count;                 /**< Number of seats. */
+    int group_count;                /**< Number of groups. */
+    int *group_start;               /**< First reserved seat of each group. */
+    int *group_size;                /**< Reserved seats of each group. */
+    unsigned long long *group_mask; /**< Segment mask of each group. */
+    int *assignment;                /**< Seat of each reserved seat or -1. */
+    unsigned long long *seat_config; /**< Reserved segments of each seat. */
+    unsigned int random;             /**< State of the random generator. */
+} Solver;
+
+static long now_us();
+static unsigned int next_random(Solver *solver);
+static int first_segment(unsigned long long mask);
+static void order_by_origin(Solver *solver, int order[]);
+static long decode(Solver *solver, const int order[]);
+static int count_groups_split(Solver *solver, const int assignment[]);
+static void move(Solver *solver, int order[]);
+static int place_split(Solver *solver, SeatCollection *collection,
+                       unsigned long long mask, int res_id);
+
+// Public definitions
+
+SeatCollection *optimize_reservation_anytime(unsigned long long res_arr[],
+                                             int res_arr_count, int res_ids[],
+                                             int segment_count, int seat_ids[],
+                                             int seat_count,
+                                             long deadline_us) {
+    long start_us = now_us();
+
+    // parameter check
+    if (res_arr_count <= 0 ||
+        segment_count > (int)sizeof(unsigned long long) * 8) {
+        return NULL;
+    }
+
+    // a group is a run of equal reservation ids
+    Solver solver;
+    solver.res_arr = res_arr;
+    solver.res_count = res_arr_count;
+    solver.seat_count = seat_count;
+    solver.random = SOLVER_SEED;
+    solver.group_start = (int *)malloc(sizeof(int) * res_arr_count);
+    solver.group_size = (int *)malloc(sizeof(int) * res_arr_count);
+    solver.group_mask = (unsigned long long *)malloc(
+        sizeof(unsigned long long) * res_arr_count);
+    solver.group_count = 0;
+    for (int j = 0; j < res_arr_count; ++j) {
+        if (j == 0 || res_ids[j] != res_ids[j - 1]) {
+            solver.group_start[solver.group_count] = j;
+            solver.group_size[solver.group_count] = 0;
+            solver.group_mask[solver.group_count++] = 0;
+        }
+        ++solver.group_size[solver.group_count - 1];
+        solver.group_mask[solver.group_count - 1] |= res_arr[j];
+    }
+    solver.assignment = (int *)malloc(sizeof(int) * res_arr_count);
+    solver.seat_config = (unsigned long long *)malloc(
+        sizeof(unsigned long long) * (seat_count > 0 ? seat_count : 1));
+
+    int *order = (int *)malloc(sizeof(int) * solver.group_count);
+    int *candidate = (int *)malloc(sizeof(int) * solver.group_count);
+    int *best = (int *)malloc(sizeof(int) * res_arr_count);
+
+    // start from the greedy solution
+    order_by_origin(&solver, order);
+    long current_cost = decode(&solver, order);
+    long best_cost = current_cost;
+    memcpy(best, solver.assignment, sizeof(int) * res_arr_count);
+
+    // improve until nothing is left to improve or the deadline is reached
+    int iterations = 0;
+    while (best_cost > 0 && solver.group_count > 1 &&
+           now_us() - start_us < deadline_us) {
+        memcpy(candidate, order, sizeof(int) * solver.group_count);
+        move(&solver, candidate);
+        long cost = decode(&solver, candidate);
+        ++iterations;
+        // accept sideways moves to escape plateaus
+        if (cost <= current_cost) {
+            int *tmp = order;
+            order = candidate;
+            candidate = tmp;
+            current_cost = cost;
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            memcpy(best, solver.assignment, sizeof(int) * res_arr_count);
+        }
+    }
+
+    // create the collection of the best solution
+    SeatCollection *collection = new_seat_collection(seat_count, seat_ids);
+    memset(solver.seat_config, 0, sizeof(unsigned long long) * seat_count);
+    for (int j = 0; j < res_arr_count; ++j) {
+        if (best[j] < 0) continue;
+        solver.seat_config[best[j]] |= res_arr[j];
+        seat_add_reservation(collection->seat_arr[best[j]], res_ids[j]);
+    }
+
+    // distribute the remaining reserved seats over several seats
+    OptimizeQuality *quality = &collection->quality;
+    quality->groups_split = count_groups_split(&solver, best);
+    for (int j = 0; j < res_arr_count; ++j) {
+        if (best[j] >= 0) continue;
+        int changes = place_split(&solver, collection, res_arr[j], res_ids[j]);
+        if (changes < 0) {
+            ++quality->unplaced;
+        } else {
+            quality->seat_changes += changes;
+        }
+    }
+    memcpy(collection->segments, solver.seat_config,
+           sizeof(unsigned long long) * seat_count);
+    quality->seat_changes_per_passenger =
+        (double)quality->seat_changes / res_arr_count;
+    quality->iterations = iterations;
+    quality->deadline_us = deadline_us;
+    quality->elapsed_us = now_us() - start_us;
+    seat_collection_build_index(collection);
+
+    free(best);
+    free(candidate);
+    free(order);
+    free(solver.seat_config);
+    free(solver.assignment);
+    free(solver.group_mask);
+    free(solver.group_size);
+    free(solver.group_start);
+    return collection;
+}
+
+// Private definitions
+
+// Monotonic time in microseconds.
+static long now_us() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000L + time.tv_nsec / 1000L;
+}
+
+// Linear congruential generator, independent of the global rand() state.
+static unsigned int next_random(Solver *solver) {
+    solver->random = solver->random * 1103515245u + 12345u;
+    return solver->random >> 16;
+}
+
+// First reserved segment of a mask.
+static int first_segment(unsigned long long mask) {
+    int segment = 0;
+    if (mask == 0) return 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++segment;
+    }
+    return segment;
+}
+
+// Order the groups by their first segment (stable counting sort).
+static void order_by_origin(Solver *solver, int order[]) {
+    int bucket[sizeof(unsigned long long) * 8 + 1] = {0};
+    for (int g = 0; g < solver->group_count; ++g)
+        ++bucket[first_segment(solver->group_mask[g]) + 1];
+    for (int i = 1; i <= (int)sizeof(unsigned long long) * 8; ++i)
+        bucket[i] += bucket[i - 1];
+    for (int g = 0; g < solver->group_count; ++g)
+        order[bucket[first_segment(solver->group_mask[g])]++] = g;
+}
+
+// Place the groups in the given order and return the cost of the solution.
+static long decode(Solver *solver, const int order[]) {
+    memset(solver->seat_config, 0,
+           sizeof(unsigned long long) * solver->seat_count);
+    int unplaced = 0;
+
+    for (int n = 0; n < solver->group_count; ++n) {
+        int g = order[n];
+        int size = solver->group_size[g];
+        unsigned long long mask = solver->group_mask[g];
+
+        // search a window of adjacent seats free along the group segments
+        int window = -1;
+        int run = 0;
+        for (int i = 0; i < solver->seat_count; ++i) {
+            run = (solver->seat_config[i] & mask) == 0 ? run + 1 : 0;
+            if (run == size) {
+                window = i - size + 1;
+                break;
+            }
+        }
+
+        for (int k = 0; k < size; ++k) {
+            int j = solver->group_start[g] + k;
+            int seat = -1;
+            if (window >= 0) {
+                seat = window + k;
+            } else {
+                for (int i = 0; i < solver->seat_count; ++i) {
+                    if ((solver->seat_config[i] & solver->res_arr[j]) == 0) {
+                        seat = i;
+                        break;
+                    }
+                }
+            }
+            solver->assignment[j] = seat;
+            if (seat < 0) {
+                ++unplaced;
+                continue;
+            }
+            solver->seat_config[seat] |= solver->res_arr[j];
+        }
+    }
+
+    // unplaced seats weigh more than all possible splits
+    return (long)unplaced * (solver->group_count + 1) +
+           count_groups_split(solver, solver->assignment);
+}
+
+// Count the groups which are not seated side by side.
+static int count_groups_split(Solver *solver, const int assignment[]) {
+    int split = 0;
+    for (int g = 0; g < solver->group_count; ++g) {
+        int size = solver->group_size[g];
+        if (size < 2) continue;
+        int min = solver->seat_count;
+        int max = -1;
+        for (int k = 0; k < size; ++k) {
+            int seat = assignment[solver->group_start[g] + k];
+            if (seat < 0) {
+                max = -1;
+                break;
+            }
+            if (seat < min) min = seat;
+            if (seat > max) max = seat;
+        }
+        if (max < 0 || max - min != size - 1) ++split;
+    }
+    return split;
+}
+
+// Swap two groups or move a group forward in the placement order.
+static void move(Solver *solver, int order[]) {
+    int i = next_random(solver) % solver->group_count;
+    int j = next_random(solver) % solver->group_count;
+    if (i == j) return;
+    if (next_random(solver) % 2 == 0) {
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+        return;
+    }
+    if (i > j) {
+        int tmp = i;
+        i = j;
+        j = tmp;
+    }
+    int group = order[j];
+    memmove(&order[i + 1], &order[i], sizeof(int) * (j - i));
+    order[i] = group;
+}
+
+// Place a reserved seat on several seats, return the seat changes or -1.
+static int place_split(Solver *solver, SeatCollection *collection,
+                       unsigned long long mask, int res_id) {
+    // every segment needs a free seat
+    for (unsigned long long rest = mask; rest != 0; rest &= rest - 1) {
+        unsigned long long bit = rest & (~rest + 1);
+        int free = 0;
+        for (int i = 0; i < solver->seat_count && !free; ++i)
+            free = (solver->seat_config[i] & bit) == 0;
+        if (!free) return -1;
+    }
+
+    // cover the segments with the longest free runs
+    int changes = -1;
+    unsigned long long rest = mask;
+    while (rest != 0) {
+        int segment = first_segment(rest);
+        int best_seat = -1;
+        unsigned long long best_run = 0;
+        int best_length = 0;
+        for (int i = 0; i < solver->seat_count; ++i) {
+            unsigned long long run = 0;
+            int length = 0;
+            for (int s = segment; s < (int)sizeof(unsigned long long) * 8;
+                 ++s) {
+                unsigned long long bit = 1ull << s;
+                if ((rest & bit) == 0 || (solver->seat_config[i] & bit)) break;
+                run |= bit;
+                ++length;
+            }
+            if (length > best_length) {
+                best_seat = i;
+                best_run = run;
+                best_length = length;
+            }
+        }
+        solver->seat_config[best_seat] |= best_run;
+        seat_add_reservation(collection->seat_arr[best_seat], res_id);
+        rest &= ~best_run;
+        ++changes;
+    }
+    return changes;
+}
@@ -0,0 +1,165 @@
+/**
+ * @brief Optimization strategy kernels for one segment mask width.
+ *
+ * This file is a template and has no include guard. It is included by
+ * optimize.c once per mask width, after defining:
+ *  - MASK_TYPE: The unsigned integer type holding the segment bits.
+ *  - MASK_BITS: The number of bits of MASK_TYPE.
+ *  - KERNEL(name): The name of the specialized function.
+ *
+ * @file kernels.h
+ * @date: 2026-10-18
+ * @author: Tobias Meier, Merlin Unterfinger
+ */
+
+// Logical representation of a fully booked seat (all segments reserved).
+static MASK_TYPE KERNEL(full_mask)(int segment_count) {
+    if (segment_count >= MASK_BITS) return ~(MASK_TYPE)0;
+    return ((MASK_TYPE)1 << segment_count) - 1;
+}
+
+// Fill seat after seat with as many non-overlapping reservations as possible.
+static void KERNEL(optimize_sparsest)(OptimizeWorkspace* workspace,
+                                      MASK_TYPE res_arr[], int res_arr_count,
+                                      int res_ids[], int segment_count,
+                                      SeatCollection* collection) {
+    MASK_TYPE full = KERNEL(full_mask)(segment_count);
+
+    // iterate over each seat
+    for (int i = 0; i < collection->seat_count; ++i) {
+        MASK_TYPE current_res_config = 0;
+
+        // iterate over each reservation
+        for (int j = 0; j < res_arr_count; ++j) {
+            if (res_arr[j] == 0) continue;
+            // break if a seat is fully booked (over all segments)
+            if (current_res_config == full) break;
+            // add the reservation to the current seat if there is space
+            // bitwise AND equals to 0 if there is no overlap
+            if ((current_res_config & res_arr[j]) == 0) {
+                current_res_config |= res_arr[j];
+                seat_add_reservation(collection->seat_arr[i], res_ids[j]);
+                // remove the reservation from the array
+                res_arr[j] = 0;
+            }
+        }
+        collection->segments[i] = current_res_config;
+    }
+}
+
+// First reserved segment of a reservation.
+static int KERNEL(first_segment)(MASK_TYPE mask) {
+    int segment = 0;
+    if (mask == 0) return 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++segment;
+    }
+    return segment;
+}
+
+// Stable counting sort of reservation indices by their first segment.
+static void KERNEL(sort_by_origin)(MASK_TYPE res_arr[], int index[],
+                                   int count, int sorted[]) {
+    int bucket[MASK_BITS + 1] = {0};
+    for (int i = 0; i < count; ++i)
+        ++bucket[KERNEL(first_segment)(res_arr[index[i]]) + 1];
+    for (int i = 1; i <= MASK_BITS; ++i) bucket[i] += bucket[i - 1];
+    for (int i = 0; i < count; ++i)
+        sorted[bucket[KERNEL(first_segment)(res_arr[index[i]])]++] = index[i];
+}
+
+// Place the reservations ordered by origin on the first free seat (left-edge).
+static void KERNEL(optimize_compact)(OptimizeWorkspace* workspace,
+                                     MASK_TYPE res_arr[], int res_arr_count,
+                                     int res_ids[], int segment_count,
+                                     SeatCollection* collection) {
+    int seat_count = collection->seat_count;
+    unsigned long long* seat_config = workspace->seat_config;
+    int* index = workspace->index;
+    int* order = workspace->order;
+    memset(seat_config, 0, sizeof(unsigned long long) * seat_count);
+    for (int j = 0; j < res_arr_count; ++j) index[j] = j;
+    KERNEL(sort_by_origin)(res_arr, index, res_arr_count, order);
+
+    for (int n = 0; n < res_arr_count; ++n) {
+        int j = order[n];
+        if (res_arr[j] == 0) continue;
+        for (int i = 0; i < seat_count; ++i) {
+            if ((seat_config[i] & res_arr[j]) == 0) {
+                seat_config[i] |= res_arr[j];
+                seat_add_reservation(collection->seat_arr[i], res_ids[j]);
+                res_arr[j] = 0;
+                break;
+            }
+        }
+    }
+    memcpy(collection->segments, seat_config,
+           sizeof(unsigned long long) * seat_count);
+}
+
+// Place the seats of a group side by side, fall back to compact placement.
+static void KERNEL(optimize_group_adjacent)(OptimizeWorkspace* workspace,
+                                            MASK_TYPE res_arr[],
+                                            int res_arr_count, int res_ids[],
+                                            int segment_count,
+                                            SeatCollection* collection) {
+    int seat_count = collection->seat_count;
+    unsigned long long* seat_config = workspace->seat_config;
+    int* index = workspace->index;
+    int* order = workspace->order;
+    memset(seat_config, 0, sizeof(unsigned long long) * seat_count);
+
+    // a group is a run of equal reservation ids, ordered by origin
+    int group_count = 0;
+    for (int j = 0; j < res_arr_count; ++j) {
+        if (j == 0 || res_ids[j] != res_ids[j - 1]) index[group_count++] = j;
+    }
+    KERNEL(sort_by_origin)(res_arr, index, group_count, order);
+
+    for (int n = 0; n < group_count; ++n) {
+        int j = order[n];
+        int group_end = j + 1;
+        while (group_end < res_arr_count && res_ids[group_end] == res_ids[j])
+            ++group_end;
+        int group_size = 0;
+        MASK_TYPE group_mask = 0;
+        for (int k = j; k < group_end; ++k) {
+            if (res_arr[k] == 0) continue;
+            group_mask |= res_arr[k];
+            ++group_size;
+        }
+
+        // search a window of adjacent seats free along the group segments
+        int start = -1;
+        int run = 0;
+        for (int i = 0; group_size > 0 && i < seat_count; ++i) {
+            run = (seat_config[i] & group_mask) == 0 ? run + 1 : 0;
+            if (run == group_size) {
+                start = i - group_size + 1;
+                break;
+            }
+        }
+
+        for (int k = j; k < group_end; ++k) {
+            if (res_arr[k] == 0) continue;
+            int seat = -1;
+            if (start >= 0) {
+                seat = start++;
+            } else {
+                for (int i = 0; i < seat_count; ++i) {
+                    if ((seat_config[i] & res_arr[k]) == 0) {
+                        seat = i;
+                        break;
+                    }
+                }
+            }
+            if (seat < 0) continue;
+            seat_config[seat] |= res_arr[k];
+            seat_add_reservation(collection->seat_arr[seat], res_ids[k]);
+            res_arr[k] = 0;
+        }
+    }
+    memcpy(collection->segments, seat_config,
+           sizeof(unsigned long long) * seat_count);
+}
@@ -7,6 +7,45 @@
 
 #include "osurs/optimize.h"
 
+#include <stdio.h>
+#include <string.h>
+
+/** The initial length of the reservation id array of a seat. */
+#define INIT_SEAT_RES_CAPACITY 8
+
+// Private declarations
+
+// Kernels for routes up to 32 segments
+#define MASK_TYPE unsigned int
+#define MASK_BITS 32
+#define KERNEL(name) name##_narrow
+#include "kernels.h"
+#undef MASK_TYPE
+#undef MASK_BITS
+#undef KERNEL
+
+// Kernels for routes up to 64 segments
+#define MASK_TYPE unsigned long long
+#define MASK_BITS 64
+#define KERNEL(name) name##_wide
+#include "kernels.h"
+#undef MASK_TYPE
+#undef MASK_BITS
+#undef KERNEL
+
+static int index_slot(const SeatIndex* index, int res_id);
+static int lowest_bit(unsigned long long bits);
+
+// Registry of the strategies, indexed by OptimizeStrategy
+static const OptimizeStrategyInfo strategies[OPTIMIZE_STRATEGY_COUNT] = {
+    {"sparsest", OPTIMIZE_SPARSEST, optimize_sparsest_narrow,
+     optimize_sparsest_wide},
+    {"compact", OPTIMIZE_COMPACT, optimize_compact_narrow,
+     optimize_compact_wide},
+    {"group-adjacent", OPTIMIZE_GROUP_ADJACENT, optimize_group_adjacent_narrow,
+     optimize_group_adjacent_wide},
+};
+
 // Public definitions
 
 // Seat constructor
@@ -14,12 +53,18 @@ Seat* new_seat(int seat_id) {
     Seat* seat = (Seat*)malloc(sizeof(Seat));
     seat->res_count = 0;
     seat->seat_id = seat_id;
-    seat->res_id_arr = (int*)malloc(sizeof(unsigned int) * 8);
+    seat->res_capacity = INIT_SEAT_RES_CAPACITY;
+    seat->res_id_arr = (int*)malloc(sizeof(int) * seat->res_capacity);
     return seat;
 }
 
 // Add a new reservation to a seat
 void seat_add_reservation(Seat* seat, int res_id) {
+    if (seat->res_count == seat->res_capacity) {
+        seat->res_capacity *= 2;
+        seat->res_id_arr =
+            (int*)realloc(seat->res_id_arr, sizeof(int) * seat->res_capacity);
+    }
     seat->res_id_arr[seat->res_count] = res_id;
     seat->res_count++;
 }
@@ -36,7 +81,14 @@ SeatCollection* new_seat_collection(int seat_count, int seat_ids[]) {
     SeatCollection* collection =
         (SeatCollection*)malloc(sizeof(SeatCollection));
     collection->seat_count = seat_count;
+    collection->seat_capacity = seat_count;
+    collection->res_covered = 0;
+    collection->res_source = NULL;
+    collection->index = NULL;
+    memset(&collection->quality, 0, sizeof(OptimizeQuality));
     collection->seat_arr = (Seat**)malloc(seat_count * sizeof(Seat*));
+    collection->segments = (unsigned long long*)calloc(
+        seat_count > 0 ? seat_count : 1, sizeof(unsigned long long));
     for (int i = 0; i < seat_count; ++i) {
         collection->seat_arr[i] = new_seat(seat_ids[i]);
     }
@@ -48,10 +100,123 @@ void delete_seat_collection(SeatCollection* collection) {
     for (int i = 0; i < collection->seat_count; ++i) {
         delete_seat(collection->seat_arr[i]);
     }
+    seat_collection_clear_index(collection);
+    free(collection->segments);
     free(collection->seat_arr);
     free(collection);
 }
 
+size_t seat_collection_memory(const SeatCollection* collection) {
+    size_t bytes = sizeof(SeatCollection);
+    int capacity = collection->seat_capacity;
+    bytes += sizeof(Seat*) * capacity;
+    bytes += sizeof(unsigned long long) * (capacity > 0 ? capacity : 1);
+    for (int i = 0; i < collection->seat_count; ++i) {
+        bytes += sizeof(Seat);
+        bytes += sizeof(int) * collection->seat_arr[i]->res_capacity;
+    }
+    SeatIndex* index = collection->index;
+    if (index != NULL) {
+        bytes += sizeof(SeatIndex) + sizeof(int) * 3 * index->capacity;
+        bytes += sizeof(int) * index->seat_capacity;
+    }
+    return bytes;
+}
+
+void seat_collection_build_index(SeatCollection* collection) {
+    SeatIndex* index = collection->index;
+    if (index == NULL) {
+        index = (SeatIndex*)calloc(1, sizeof(SeatIndex));
+        if (index == NULL) {
+            perror("Error allocating memory for seat index");
+            exit(1);
+        }
+        collection->index = index;
+    }
+
+    // at most half of the slots are used, the arrays of an earlier index of
+    // the collection are reused if they are large enough
+    int entries = 0;
+    for (int i = 0; i < collection->seat_count; ++i)
+        entries += collection->seat_arr[i]->res_count;
+    int capacity = 2;
+    while (capacity < entries * 2) capacity *= 2;
+    if (capacity > index->capacity) {
+        free(index->res_ids);
+        free(index->start);
+        free(index->count);
+        index->capacity = capacity;
+        index->res_ids = (int*)malloc(sizeof(int) * capacity);
+        index->start = (int*)malloc(sizeof(int) * capacity);
+        index->count = (int*)malloc(sizeof(int) * capacity);
+    }
+    if (entries > index->seat_capacity || index->seat_ids == NULL) {
+        free(index->seat_ids);
+        index->seat_capacity = entries > 0 ? entries : 1;
+        index->seat_ids = (int*)malloc(sizeof(int) * index->seat_capacity);
+    }
+    if (index->res_ids == NULL || index->start == NULL ||
+        index->count == NULL || index->seat_ids == NULL) {
+        perror("Error allocating memory for seat index");
+        exit(1);
+    }
+    memset(index->res_ids, -1, sizeof(int) * index->capacity);
+    memset(index->count, 0, sizeof(int) * index->capacity);
+
+    // count the seats of each reservation
+    for (int i = 0; i < collection->seat_count; ++i) {
+        Seat* seat = collection->seat_arr[i];
+        for (int j = 0; j < seat->res_count; ++j) {
+            int slot = index_slot(index, seat->res_id_arr[j]);
+            index->res_ids[slot] = seat->res_id_arr[j];
+            ++index->count[slot];
+        }
+    }
+
+    // group the seat ids by reservation
+    int offset = 0;
+    for (int slot = 0; slot < index->capacity; ++slot) {
+        index->start[slot] = offset;
+        offset += index->count[slot];
+        index->count[slot] = 0;
+    }
+    for (int i = 0; i < collection->seat_count; ++i) {
+        Seat* seat = collection->seat_arr[i];
+        for (int j = 0; j < seat->res_count; ++j) {
+            int slot = index_slot(index, seat->res_id_arr[j]);
+            index->seat_ids[index->start[slot] + index->count[slot]++] =
+                seat->seat_id;
+        }
+    }
+}
+
+void seat_collection_clear_index(SeatCollection* collection) {
+    SeatIndex* index = collection->index;
+    if (index == NULL) return;
+    free(index->seat_ids);
+    free(index->count);
+    free(index->start);
+    free(index->res_ids);
+    free(index);
+    collection->index = NULL;
+}
+
+const int* seat_collection_find(const SeatCollection* collection, int res_id,
+                                int* count) {
+    const SeatIndex* index = collection->index;
+    if (index == NULL) {
+        *count = 0;
+        return NULL;
+    }
+    int slot = index_slot(index, res_id);
+    if (index->res_ids[slot] != res_id) {
+        *count = 0;
+        return NULL;
+    }
+    *count = index->count[slot];
+    return &index->seat_ids[index->start[slot]];
+}
+
 int space_available(unsigned int res_arr[], int res_count, int segment_count,
                     unsigned int seat_count, unsigned int new_res) {
     // iterate over each segment
@@ -73,45 +238,126 @@ int space_available(unsigned int res_arr[], int res_count, int segment_count,
 SeatCollection* optimize_reservation(unsigned int res_arr[], int res_arr_count,
                                      int res_ids[], int segment_count,
                                      int seat_ids[], int seat_count) {
+    return optimize_reservation_with(OPTIMIZE_SPARSEST, res_arr, res_arr_count,
+                                     res_ids, segment_count, seat_ids,
+                                     seat_count);
+}
+
+const OptimizeStrategyInfo* get_optimize_strategy(OptimizeStrategy strategy) {
+    if (strategy < 0 || strategy >= OPTIMIZE_STRATEGY_COUNT) return NULL;
+    return &strategies[strategy];
+}
+
+const OptimizeStrategyInfo* get_optimize_strategy_by_name(const char* name) {
+    for (int i = 0; i < OPTIMIZE_STRATEGY_COUNT; ++i) {
+        if (strcmp(strategies[i].name, name) == 0) return &strategies[i];
+    }
+    return NULL;
+}
+
+SeatCollection* optimize_reservation_with(OptimizeStrategy strategy,
+                                          unsigned int res_arr[],
+                                          int res_arr_count, int res_ids[],
+                                          int segment_count, int seat_ids[],
+                                          int seat_count) {
+    const OptimizeStrategyInfo* info = get_optimize_strategy(strategy);
+
     // parameter check
-    if (res_arr_count <= 0) {
+    if (info == NULL || res_arr_count <= 0) {
         return NULL;
     }
 
     // datatype size check
-    if (segment_count > sizeof(unsigned int) * 8) {
+    if (segment_count > (int)sizeof(unsigned int) * 8) {
         return NULL;
     }
 
+    // the scratch buffers are only used for this call
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    optimize_workspace_reserve(workspace, 0, res_arr_count, seat_count);
     SeatCollection* collection = new_seat_collection(seat_count, seat_ids);
+    info->optimize(workspace, res_arr, res_arr_count, res_ids, segment_count,
+                   collection);
+    seat_collection_build_index(collection);
+    delete_optimize_workspace(workspace);
+    return collection;
+}
 
-    // iterate over each seat
-    for (int i = 0; i < seat_count; ++i) {
-        unsigned int current_res_config = 0;
-
-        // iterate over each reservation
-        for (int j = 0; j < res_arr_count; ++j) {
-            //
-            if (res_arr[j] != 0) {
-                // break if a seat is fully booked (over all segments)
-                // fully booked = logical representation of all ones
-                // all ones = 2^segment_count - 1
-                if (current_res_config == ((1 << segment_count) - 1)) {
-                    break;
-                }
-                // add the reservation to the current seat if there is space
-                // bitwise AND equals to 0 if there is no overlap
-                if ((current_res_config & res_arr[j]) == 0) {
-                    // add the logical representation of the current reservation
-                    // to the current seat representation (bitwise OR)
-                    current_res_config |= res_arr[j];
-                    // add the reservation id to the seat
-                    seat_add_reservation(collection->seat_arr[i], res_ids[j]);
-                    // remove the reservation from the array
-                    res_arr[j] = 0;
-                }
-            }
-        }
+SeatCollection* optimize_reservation_wide(OptimizeStrategy strategy,
+                                          unsigned long long res_arr[],
+                                          int res_arr_count, int res_ids[],
+                                          int segment_count, int seat_ids[],
+                                          int seat_count) {
+    const OptimizeStrategyInfo* info = get_optimize_strategy(strategy);
+
+    // parameter check
+    if (info == NULL || res_arr_count <= 0) {
+        return NULL;
+    }
+
+    // datatype size check
+    if (segment_count > (int)sizeof(unsigned long long) * 8) {
+        return NULL;
     }
+
+    // the scratch buffers are only used for this call
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    optimize_workspace_reserve(workspace, 0, res_arr_count, seat_count);
+    SeatCollection* collection = new_seat_collection(seat_count, seat_ids);
+    info->optimize_wide(workspace, res_arr, res_arr_count, res_ids, segment_count,
+                        collection);
+    seat_collection_build_index(collection);
+    delete_optimize_workspace(workspace);
     return collection;
-}
\ No newline at end of file
+}
+
+int find_free_seats(SeatCollection* collection, int from, int to, int out[],
+                    int max) {
+    if (from < 0 || to <= from || to - from > 64) return 0;
+    unsigned long long mask = (~0ull >> (64 - (to - from))) << from;
+    const unsigned long long* segments = collection->segments;
+    int count = 0;
+
+    // test blocks of 64 seats without branches, then collect the free ones
+    for (int block = 0; block < collection->seat_count && count < max;
+         block += 64) {
+        int size = collection->seat_count - block;
+        if (size > 64) size = 64;
+        unsigned long long free_bits = 0;
+        for (int k = 0; k < size; ++k) {
+            unsigned long long is_free = (segments[block + k] & mask) == 0;
+            free_bits |= is_free << k;
+        }
+        while (free_bits != 0 && count < max) {
+            int k = lowest_bit(free_bits);
+            out[count++] = collection->seat_arr[block + k]->seat_id;
+            free_bits &= free_bits - 1;
+        }
+    }
+    return count;
+}
+
+// Private definitions
+
+// Slot of a reservation id or the empty slot where it would be inserted.
+static int index_slot(const SeatIndex* index, int res_id) {
+    unsigned int mask = (unsigned int)index->capacity - 1;
+    unsigned int slot = ((unsigned int)res_id * 2654435761u) & mask;
+    while (index->res_ids[slot] != -1 && index->res_ids[slot] != res_id)
+        slot = (slot + 1) & mask;
+    return (int)slot;
+}
+
+// Index of the lowest set bit.
+static int lowest_bit(unsigned long long bits) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
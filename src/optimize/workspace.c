@@ -0,0 +1,187 @@
+/**
+ * @brief Reusable optimization workspace.
+ * @file workspace.c
+ * @date: 2026-10-18
+ * @author: Tobias Meier, Merlin Unterfinger
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "osurs/optimize.h"
+
+// Private declarations
+
+static SeatCollection* workspace_collection(OptimizeWorkspace* workspace,
+                                            int seat_count, int seat_ids[]);
+static void* grow(void* ptr, int* capacity, int count, size_t size);
+
+// Public definitions
+
+OptimizeWorkspace* new_optimize_workspace() {
+    OptimizeWorkspace* workspace =
+        (OptimizeWorkspace*)calloc(1, sizeof(OptimizeWorkspace));
+    if (workspace == NULL) {
+        perror("Error allocating memory for optimize workspace");
+        exit(1);
+    }
+    return workspace;
+}
+
+void optimize_workspace_reserve(OptimizeWorkspace* workspace, int res_count,
+                                int seat_res_count, int seat_count) {
+    if (res_count > workspace->trip_capacity) {
+        int capacity = workspace->trip_capacity;
+        workspace->trip_masks = (unsigned long long*)grow(
+            workspace->trip_masks, &capacity, res_count,
+            sizeof(unsigned long long));
+        workspace->trip_capacity = capacity;
+    }
+    if (seat_res_count > workspace->capacity) {
+        // all reserved seat arrays share the same capacity
+        int capacity = workspace->capacity;
+        workspace->masks = (unsigned long long*)grow(
+            workspace->masks, &capacity, seat_res_count,
+            sizeof(unsigned long long));
+        capacity = workspace->capacity;
+        workspace->narrow_masks = (unsigned int*)grow(
+            workspace->narrow_masks, &capacity, seat_res_count,
+            sizeof(unsigned int));
+        capacity = workspace->capacity;
+        workspace->res_ids = (int*)grow(workspace->res_ids, &capacity,
+                                        seat_res_count, sizeof(int));
+        capacity = workspace->capacity;
+        workspace->index = (int*)grow(workspace->index, &capacity,
+                                      seat_res_count, sizeof(int));
+        capacity = workspace->capacity;
+        workspace->order = (int*)grow(workspace->order, &capacity,
+                                      seat_res_count, sizeof(int));
+        workspace->capacity = capacity;
+    }
+    if (seat_count > workspace->seat_capacity) {
+        int capacity = workspace->seat_capacity;
+        workspace->seat_config = (unsigned long long*)grow(
+            workspace->seat_config, &capacity, seat_count,
+            sizeof(unsigned long long));
+        workspace->seat_capacity = capacity;
+    }
+}
+
+SeatCollection* optimize_reservation_in(OptimizeWorkspace* workspace,
+                                        OptimizeStrategy strategy,
+                                        unsigned long long res_arr[],
+                                        int res_arr_count, int res_ids[],
+                                        int segment_count, int seat_ids[],
+                                        int seat_count) {
+    const OptimizeStrategyInfo* info = get_optimize_strategy(strategy);
+
+    // parameter check
+    if (info == NULL || res_arr_count <= 0 ||
+        segment_count > (int)sizeof(unsigned long long) * 8) {
+        return NULL;
+    }
+
+    optimize_workspace_reserve(workspace, 0, res_arr_count, seat_count);
+    SeatCollection* collection =
+        workspace_collection(workspace, seat_count, seat_ids);
+
+    // routes up to 32 segments run on the narrow kernels
+    if (segment_count <= (int)sizeof(unsigned int) * 8) {
+        unsigned int* narrow_masks = workspace->narrow_masks;
+        for (int j = 0; j < res_arr_count; ++j)
+            narrow_masks[j] = (unsigned int)res_arr[j];
+        info->optimize(workspace, narrow_masks, res_arr_count, res_ids,
+                       segment_count, collection);
+        for (int j = 0; j < res_arr_count; ++j)
+            if (narrow_masks[j] == 0) res_arr[j] = 0;
+    } else {
+        info->optimize_wide(workspace, res_arr, res_arr_count, res_ids,
+                            segment_count, collection);
+    }
+    seat_collection_build_index(collection);
+    return collection;
+}
+
+SeatCollection* optimize_workspace_detach(OptimizeWorkspace* workspace) {
+    SeatCollection* collection = workspace->collection;
+    if (collection == NULL) return NULL;
+    for (int i = collection->seat_count; i < workspace->collection_capacity;
+         ++i)
+        delete_seat(collection->seat_arr[i]);
+    workspace->collection = NULL;
+    workspace->collection_capacity = 0;
+    return collection;
+}
+
+void delete_optimize_workspace(OptimizeWorkspace* workspace) {
+    if (workspace == NULL) return;
+    SeatCollection* collection = workspace->collection;
+    if (collection != NULL) {
+        seat_collection_clear_index(collection);
+        for (int i = 0; i < workspace->collection_capacity; ++i)
+            delete_seat(collection->seat_arr[i]);
+        free(collection->segments);
+        free(collection->seat_arr);
+        free(collection);
+    }
+    free(workspace->seat_config);
+    free(workspace->order);
+    free(workspace->index);
+    free(workspace->res_ids);
+    free(workspace->narrow_masks);
+    free(workspace->masks);
+    free(workspace->trip_masks);
+    free(workspace);
+}
+
+// Private definitions
+
+// Reset the output collection to empty seats with the given ids.
+static SeatCollection* workspace_collection(OptimizeWorkspace* workspace,
+                                            int seat_count, int seat_ids[]) {
+    SeatCollection* collection = workspace->collection;
+    if (collection == NULL) {
+        collection = new_seat_collection(0, NULL);
+        workspace->collection = collection;
+        workspace->collection_capacity = 0;
+    }
+
+    // keep the seats (and their reservation arrays) of earlier calls
+    if (seat_count > workspace->collection_capacity) {
+        int capacity = workspace->collection_capacity;
+        collection->seat_arr = (Seat**)grow(collection->seat_arr, &capacity,
+                                            seat_count, sizeof(Seat*));
+        capacity = workspace->collection_capacity;
+        collection->segments = (unsigned long long*)grow(
+            collection->segments, &capacity, seat_count,
+            sizeof(unsigned long long));
+        for (int i = workspace->collection_capacity; i < capacity; ++i)
+            collection->seat_arr[i] = new_seat(0);
+        workspace->collection_capacity = capacity;
+        collection->seat_capacity = capacity;
+    }
+    for (int i = 0; i < seat_count; ++i) {
+        Seat* seat = collection->seat_arr[i];
+        seat->seat_id = seat_ids[i];
+        seat->res_count = 0;
+    }
+    memset(collection->segments, 0, sizeof(unsigned long long) * seat_count);
+    collection->seat_count = seat_count;
+    collection->res_covered = 0;
+    collection->res_source = NULL;
+    memset(&collection->quality, 0, sizeof(OptimizeQuality));
+    return collection;
+}
+
+// Grow an array to at least count elements, doubling its capacity.
+static void* grow(void* ptr, int* capacity, int count, size_t size) {
+    int new_capacity = *capacity > 0 ? *capacity : 16;
+    while (new_capacity < count) new_capacity *= 2;
+    ptr = realloc(ptr, new_capacity * size);
+    if (ptr == NULL) {
+        perror("Error allocating memory for optimize workspace buffer");
+        exit(1);
+    }
+    *capacity = new_capacity;
+    return ptr;
+}
@@ -20,21 +20,33 @@ static int min(int a, int b);
 static Stop *iterate_to_orig(Stop *curr_stop, const Node *orig,
                              const Node *dest, int *departure);
 
+static int stop_reserved(const Stop *stop, int trip_count,
+                         const ServiceDay *day, int date);
+
 static Stop *iterate_to_dest(Stop *curr_stop, const Node *dest, int *arrival,
-                             int *available, int capacity, int trip_count);
+                             int *available, int capacity, int trip_count,
+                             const ServiceDay *day, int date);
 
 static Connection *search_trip(Connection *conn, const Node *orig,
-                               const Node *dest, int time, Trip *trip,
-                               Stop *root_stop, int trip_count, int *conn_count,
-                               int *direction);
+                               const Node *dest, int time, int date,
+                               Trip *trip, Stop *root_stop, int trip_count,
+                               int *conn_count, int *direction);
 
 static Connection *search_route(Connection *conn, const Node *orig,
-                                const Node *dest, int time, Route *route,
-                                int cutoff);
+                                const Node *dest, int time, int date,
+                                Route *route, int cutoff);
+
+static Connection *search_frozen_route(Connection *conn, FrozenNetwork *frozen,
+                                       int orig, int dest, int time, int route);
 
 // Public definitions
 
 Connection *new_connection(const Node *orig, const Node *dest, int time) {
+    return new_connection_on(orig, dest, time, -1);
+}
+
+Connection *new_connection_on(const Node *orig, const Node *dest, int time,
+                              int date) {
     // Avoid same origin and destination
     if (orig == dest) {
         return NULL;
@@ -48,16 +60,75 @@ Connection *new_connection(const Node *orig, const Node *dest, int time) {
     conn->next = NULL;
     conn->prev = NULL;
 
-    // Match and search on equal routes
-    for (size_t i = 0; i < orig->routes->capacity; i++) {
-        HashMapEntry *entry = orig->routes->entries[i];
-        while (entry != NULL) {
-            Route *route = (Route *)entry->value;
-            if (hash_map_get(dest->routes, route->id) != NULL) {
-                conn = search_route(conn, orig, dest, time, route, INT_MAX);
-            }
-            entry = entry->next;
+    // Match and search on equal routes (merge of the sorted route indices)
+    int i = 0;
+    int j = 0;
+    while (i < orig->route_count && j < dest->route_count) {
+        int a = orig->route_indices[i];
+        int b = dest->route_indices[j];
+        if (a == b) {
+            conn = search_route(conn, orig, dest, time, date,
+                                orig->routes[i], INT_MAX);
         }
+        i += a <= b;
+        j += b <= a;
+    }
+
+    // Check for no results
+    if (conn->prev == NULL && conn->next == NULL) {
+        free(conn);
+        return NULL;
+    }
+
+    // Avoid memory leak and delete last allocated empty connection
+    conn->prev->next = NULL;
+    free(conn);
+
+    return root_conn;
+}
+
+Connection *new_connection_at(Network *network, int orig, int dest, int time) {
+    Node *orig_node = network_node_at(network, orig);
+    Node *dest_node = network_node_at(network, dest);
+    if (orig_node == NULL || dest_node == NULL) return NULL;
+    return new_connection(orig_node, dest_node, time);
+}
+
+Connection *frozen_new_connection(FrozenNetwork *frozen, const Node *orig,
+                                  const Node *dest, int time) {
+    return frozen_new_connection_at(frozen, frozen_node_index(frozen, orig),
+                                    frozen_node_index(frozen, dest), time);
+}
+
+Connection *frozen_new_connection_at(FrozenNetwork *frozen, int orig, int dest,
+                                     int time) {
+    // Avoid same origin and destination and unknown nodes
+    if (orig == dest || orig < 0 || dest < 0 || orig >= frozen->node_count ||
+        dest >= frozen->node_count) {
+        return NULL;
+    }
+
+    // Allocate connection root
+    Connection *root_conn = (Connection *)malloc(sizeof(Connection));
+    Connection *conn = root_conn;
+
+    // Mark start of the chain
+    conn->next = NULL;
+    conn->prev = NULL;
+
+    // Search on the routes passing both nodes (merge of the sorted routes)
+    int i = frozen->node_route_start[orig];
+    int j = frozen->node_route_start[dest];
+    int orig_end = frozen->node_route_start[orig + 1];
+    int dest_end = frozen->node_route_start[dest + 1];
+    while (i < orig_end && j < dest_end) {
+        int a = frozen->node_routes[i];
+        int b = frozen->node_routes[j];
+        if (a == b) {
+            conn = search_frozen_route(conn, frozen, orig, dest, time, a);
+        }
+        i += a <= b;
+        j += b <= a;
     }
 
     // Check for no results
@@ -75,12 +146,14 @@ Connection *new_connection(const Node *orig, const Node *dest, int time) {
 
 int check_connection(Connection *connection, int seats, int *trip_count) {
     // Get trip number of route.
-    Trip *curr_trip = connection->trip->route->root_trip;
-    *trip_count = 0;
-    while (1) {
-        if (curr_trip == connection->trip) break;
-        curr_trip = curr_trip->next;
-        ++(*trip_count);
+    *trip_count = connection->trip->ordinal;
+
+    // Check the service day, nothing is reserved before its first booking.
+    int date = connection->date;
+    ServiceDay *day = NULL;
+    if (date >= 0) {
+        if (!trip_runs_on(connection->trip, date)) return 0;
+        day = get_service_day(connection->trip, date);
     }
 
     // Check available seats over on all visited stops.
@@ -88,7 +161,8 @@ int check_connection(Connection *connection, int seats, int *trip_count) {
     int capacity = connection->trip->vehicle->composition->seat_count;
     while (1) {
         // If less available seats than requested, return false.
-        if (seats > (capacity - curr_stop->reserved[*trip_count])) return 0;
+        int reserved = stop_reserved(curr_stop, *trip_count, day, date);
+        if (seats > (capacity - reserved)) return 0;
         // Stop if destination is reached.
         if (curr_stop == connection->dest) break;
         curr_stop = curr_stop->next;
@@ -175,12 +249,21 @@ static Stop *iterate_to_orig(Stop *curr_stop, const Node *orig,
     }
 }
 
+// Reservations on a stop of a trip, of the service day if dated.
+static int stop_reserved(const Stop *stop, int trip_count,
+                         const ServiceDay *day, int date) {
+    if (date < 0) return stop->reserved[trip_count];
+    return day == NULL ? 0 : day->reserved[stop->ordinal];
+}
+
 // Iterate to stop of destination node on trip.
 static Stop *iterate_to_dest(Stop *curr_stop, const Node *dest, int *arrival,
-                             int *available, int capacity, int trip_count) {
+                             int *available, int capacity, int trip_count,
+                             const ServiceDay *day, int date) {
     while (1) {
-        *available =
-            min(*available, capacity - curr_stop->reserved[trip_count]);
+        *available = min(*available,
+                         capacity - stop_reserved(curr_stop, trip_count, day,
+                                                  date));
         if (curr_stop->node == dest) {
             *arrival += curr_stop->arrival_offset;
             return curr_stop;
@@ -191,9 +274,9 @@ static Stop *iterate_to_dest(Stop *curr_stop, const Node *dest, int *arrival,
 
 // Search for a connection on a trip.
 static Connection *search_trip(Connection *conn, const Node *orig,
-                               const Node *dest, int time, Trip *trip,
-                               Stop *root_stop, int trip_count, int *conn_count,
-                               int *direction) {
+                               const Node *dest, int time, int date,
+                               Trip *trip, Stop *root_stop, int trip_count,
+                               int *conn_count, int *direction) {
     Stop *orig_stop;
     Stop *dest_stop;
     int departure = trip->departure;
@@ -216,9 +299,17 @@ static Connection *search_trip(Connection *conn, const Node *orig,
     arrival = departure;
 
     // Iterate over the stops until destination is reached.
-    dest_stop =
-        iterate_to_dest(orig_stop, dest, &arrival, &available,
-                        trip->vehicle->composition->seat_count, trip_count);
+    // Look up the service day under the lock, bookings insert into the array
+    ServiceDay *day = NULL;
+    if (date >= 0) {
+        Network *network = trip->route->network;
+        pthread_mutex_lock(&network->lock);
+        day = get_service_day(trip, date);
+        pthread_mutex_unlock(&network->lock);
+    }
+    dest_stop = iterate_to_dest(orig_stop, dest, &arrival, &available,
+                                trip->vehicle->composition->seat_count,
+                                trip_count, day, date);
 
     // Set values of found connection
     *conn_count += 1;
@@ -228,6 +319,7 @@ static Connection *search_trip(Connection *conn, const Node *orig,
     conn->departure = departure;
     conn->arrival = arrival;
     conn->available = available;
+    conn->date = date;
 
     // Allocate next connection on heap; Set pointer to current connection as
     // previous connection of next connection.
@@ -241,19 +333,20 @@ static Connection *search_trip(Connection *conn, const Node *orig,
 
 // Search for a connection on all trips of a route.
 static Connection *search_route(Connection *conn, const Node *orig,
-                                const Node *dest, int time, Route *route,
-                                int cutoff) {
+                                const Node *dest, int time, int date,
+                                Route *route, int cutoff) {
     Trip *curr_trip = route->root_trip;
     int trip_count = 0;
     int conn_count = 0;
     int direction = 0;
 
     while (!direction) {
-        // Search on trip if not already arrived at terminal.
-        if (curr_trip->arrival > time) {
-            conn =
-                search_trip(conn, orig, dest, time, curr_trip, route->root_stop,
-                            trip_count, &conn_count, &direction);
+        // Search on trip if not already arrived at terminal and running.
+        if (curr_trip->arrival > time &&
+            (date < 0 || trip_runs_on(curr_trip, date))) {
+            conn = search_trip(conn, orig, dest, time, date, curr_trip,
+                               route->root_stop, trip_count, &conn_count,
+                               &direction);
         }
         if (conn_count >= cutoff || curr_trip->next == NULL) return conn;
         curr_trip = curr_trip->next;
@@ -261,3 +354,60 @@ static Connection *search_route(Connection *conn, const Node *orig,
     }
     return conn;
 }
+
+// Search for connections on all trips of a route of a frozen network.
+static Connection *search_frozen_route(Connection *conn, FrozenNetwork *frozen,
+                                       int orig, int dest, int time,
+                                       int route) {
+    int first_stop = frozen->route_stop_start[route];
+    int last_stop = frozen->route_stop_start[route + 1];
+    int orig_stop = first_stop;
+    int dest_stop;
+
+    // Skip the route if the destination is passed before the origin
+    while (orig_stop < last_stop && frozen->stop_nodes[orig_stop] != orig) {
+        if (frozen->stop_nodes[orig_stop] == dest) return conn;
+        ++orig_stop;
+    }
+    dest_stop = orig_stop + 1;
+    while (dest_stop < last_stop && frozen->stop_nodes[dest_stop] != dest)
+        ++dest_stop;
+    if (orig_stop >= last_stop || dest_stop >= last_stop) return conn;
+
+    int first_trip = frozen->route_trip_start[route];
+    int last_trip = frozen->route_trip_start[route + 1];
+    for (int t = first_trip; t < last_trip; ++t) {
+        // Skip trips already arrived at the terminal or missed
+        if (frozen->trip_arrivals[t] <= time) continue;
+        int departure = frozen->trip_departures[t] +
+                        frozen->stop_departure_offsets[orig_stop];
+        if (departure < time) continue;
+
+        // Reservation counts of the trip on the stops of the route
+        const int *reserved =
+            frozen->trip_reserved + frozen->trip_reserved_start[t];
+        int available = INT_MAX;
+        for (int s = orig_stop; s <= dest_stop; ++s) {
+            available = min(available, frozen->trip_capacities[t] -
+                                           reserved[s - first_stop]);
+        }
+
+        // Set values of found connection
+        conn->trip = frozen->trips[t];
+        conn->orig = frozen->stops[orig_stop];
+        conn->dest = frozen->stops[dest_stop];
+        conn->departure = departure;
+        conn->arrival = frozen->trip_departures[t] +
+                        frozen->stop_departure_offsets[orig_stop] +
+                        frozen->stop_arrival_offsets[dest_stop];
+        conn->available = available;
+        conn->date = -1;
+
+        // Allocate next connection on heap
+        conn->next = (Connection *)malloc(sizeof(Connection));
+        Connection *conn_prev = conn;
+        conn = conn->next;
+        conn->prev = conn_prev;
+    }
+    return conn;
+}
@@ -12,6 +12,8 @@
 
 // Private declarations
 
+static Reservation *book_reservation(Connection *connection, int seats,
+                                     char *id, int trip_count);
 static void trip_add_reservation(Trip *trip, Reservation *reservation);
 static int get_next_id();
 
@@ -20,18 +22,30 @@ static int get_next_id();
 Reservation *new_reservation(Connection *connection, int seats, char *id) {
     Reservation *res = NULL;
     int trip_count;
+    if (connection == NULL) return res;
 
-    // Check connection and seat availability.
-    if (connection == NULL || seats > connection->available ||
-        !check_connection(connection, seats, &trip_count))
-        return res;
+    // Check and book under the lock, serialized with bookings and snapshots.
+    Network *network = connection->trip->route->network;
+    pthread_mutex_lock(&network->lock);
+    if (seats <= connection->available &&
+        check_connection(connection, seats, &trip_count))
+        res = book_reservation(connection, seats, id, trip_count);
+    pthread_mutex_unlock(&network->lock);
+
+    return res;
+}
+
+// Private definitions
 
+static Reservation *book_reservation(Connection *connection, int seats,
+                                     char *id, int trip_count) {
     // Allocate reservation struct.
-    res = (Reservation *)malloc(sizeof(Reservation));
+    Reservation *res = (Reservation *)malloc(sizeof(Reservation));
     res->orig = connection->orig;
     res->dest = connection->dest;
     res->trip = connection->trip;
     res->seats = seats;
+    res->date = connection->date;
 
     // Generate UUID.
     if (id == NULL) {
@@ -43,26 +57,44 @@ Reservation *new_reservation(Connection *connection, int seats, char *id) {
     // TODO: move to olal.
     res->res_id = get_next_id();
 
+    // Book on the service day of a dated connection.
+    if (connection->date >= 0) {
+        ServiceDay *day = new_service_day(connection->trip, connection->date);
+        array_list_add(service_day_reservations_for_write(day), (void *)res);
+        int *reserved = service_day_reserved_for_write(day);
+        Stop *curr_stop = connection->orig;
+        while (1) {
+            reserved[curr_stop->ordinal] += seats;
+            if (curr_stop == connection->dest) break;
+            curr_stop = curr_stop->next;
+        }
+        return res;
+    }
+
     // Connect trip to reservation.
     trip_add_reservation(connection->trip, res);
 
     // Book connection on individual stops.
     Stop *curr_stop = connection->orig;
     while (1) {
-        // Increase reservation counter.
-        curr_stop->reserved[trip_count] += seats;
+        // Increase reservation counter (copied if shared with a snapshot).
+        int *reserved =
+            stop_reserved_for_write(connection->trip->route, curr_stop);
+        reserved[trip_count] += seats;
         // Stop if destination is reached.
         if (curr_stop == connection->dest) break;
         curr_stop = curr_stop->next;
     }
+    frozen_network_reserve(connection->trip, connection->orig,
+                           connection->dest, seats);
 
     return res;
 }
 
-// Private definitions
-
 static void trip_add_reservation(Trip *trip, Reservation *reservation) {
-    array_list_add(trip->reservations, (void *)reservation);
+    array_list_add(trip_reservations_for_write(trip), (void *)reservation);
+    // invalidates the cached optimization of the trip
+    ++trip->version;
 }
 
 static int get_next_id() {
@@ -68,4 +68,5 @@ void generate_uuid(char *buffer) {
             buffer[i] = chars[rand() % 16];
         }
     }
+    buffer[UUID_LEN] = '\0';
 }
\ No newline at end of file
@@ -1,12 +1,41 @@
 #include <gtest/gtest.h>
 
 extern "C" {
+#include "osurs/ds/arena.h"
 #include "osurs/ds/arraylist.h"
 #include "osurs/ds/hashmap.h"
 #include "osurs/ds/linkedlist.h"
 #include "osurs/ds/priority.h"
 #include "osurs/ds/queue.h"
 #include "osurs/ds/stack.h"
+#include "osurs/ds/strpool.h"
+}
+
+// Arena
+
+TEST(ArenaTest, Alloc) {
+    Arena *arena = arena_create();
+
+    int *zeros = (int *)arena_calloc(arena, 100, sizeof(int));
+    for (int i = 0; i < 100; i++) EXPECT_EQ(0, zeros[i]);
+
+    // allocations are aligned and do not overlap
+    char *prev = NULL;
+    for (int i = 1; i < 2000; i++) {
+        char *data = (char *)arena_alloc(arena, i % 50 + 1);
+        EXPECT_EQ(0, (size_t)data % 16);
+        memset(data, i, i % 50 + 1);
+        if (prev != NULL) EXPECT_EQ((char)(i - 1), prev[0]);
+        prev = data;
+    }
+
+    // large allocations get their own block
+    char *large = (char *)arena_alloc(arena, 4 << 20);
+    memset(large, 1, 4 << 20);
+    EXPECT_GE(arena->reserved, arena->allocated);
+    EXPECT_LT(arena->block_count, 16);
+
+    arena_free(arena);
 }
 
 // ArrayList
@@ -96,6 +125,39 @@ TEST(HashMapTest, RandomGet) {
     hash_map_free(&map);
 }
 
+TEST(HashMapTest, RandomGetWithState) {
+    int values[4] = {0, 1, 2, 3};
+    for (int open = 0; open < 2; open++) {
+        HashMap map;
+        hash_map_init(&map);
+        if (open) hash_map_open_addressing(&map);
+        unsigned long long state = 42;
+        EXPECT_TRUE(hash_map_get_random_with(&map, &state) == NULL);
+
+        hash_map_put(&map, (char *)"key0", (void *)&values[0]);
+        hash_map_put(&map, (char *)"key1", (void *)&values[1]);
+        hash_map_put(&map, (char *)"key2", (void *)&values[2]);
+        hash_map_put(&map, (char *)"key3", (void *)&values[3]);
+        hash_map_remove(&map, (char *)"key1");
+
+        // all remaining values are drawn, the removed one never
+        int drawn[4] = {0};
+        for (int i = 0; i < 400; i++)
+            ++drawn[*(int *)hash_map_get_random_with(&map, &state)];
+        EXPECT_EQ(0, drawn[1]);
+        EXPECT_GT(drawn[0], 0);
+        EXPECT_GT(drawn[2], 0);
+        EXPECT_GT(drawn[3], 0);
+
+        // the same state draws the same values
+        unsigned long long a = 7, b = 7;
+        for (int i = 0; i < 10; i++)
+            EXPECT_EQ(hash_map_get_random_with(&map, &a),
+                      hash_map_get_random_with(&map, &b));
+        hash_map_free(&map);
+    }
+}
+
 TEST(HashMapTest, Remove) {
     HashMap map;
     hash_map_init(&map);
@@ -151,6 +213,240 @@ TEST(HashMapTest, Resize) {
     hash_map_free(&map);
 }
 
+TEST(HashMapTest, OpenAddressing) {
+    const int size = 1000;
+    int int_arr[size];
+    HashMap map;
+    hash_map_init(&map);
+    hash_map_open_addressing(&map);
+
+    EXPECT_EQ(NULL, hash_map_get(&map, (char *)"key1"));
+    EXPECT_TRUE(hash_map_get_random(&map) == NULL);
+
+    for (int i = 0; i < size; i++) {
+        char key[10];
+        int_arr[i] = i + 1;
+        sprintf(key, "key%d", i);
+        hash_map_put(&map, key, (void *)&int_arr[i]);
+    }
+    EXPECT_EQ(size, map.size);
+    EXPECT_EQ(0, map.capacity & (map.capacity - 1));
+    for (int i = 0; i < size; i++) {
+        char key[10];
+        sprintf(key, "key%d", i);
+        EXPECT_EQ(int_arr[i], *(int *)hash_map_get(&map, key));
+    }
+    int value = *(int *)hash_map_get_random(&map);
+    EXPECT_TRUE((value >= 1) && (value <= size));
+
+    // replace a value, remove every second key and reuse the deleted slots
+    hash_map_put(&map, (char *)"key0", (void *)&int_arr[1]);
+    EXPECT_EQ(int_arr[1], *(int *)hash_map_get(&map, (char *)"key0"));
+    for (int i = 0; i < size; i += 2) {
+        char key[10];
+        sprintf(key, "key%d", i);
+        hash_map_remove(&map, key);
+    }
+    hash_map_remove(&map, (char *)"missing");
+    EXPECT_EQ(size / 2, map.size);
+    for (int i = 0; i < size; i++) {
+        char key[10];
+        sprintf(key, "key%d", i);
+        if (i % 2 == 0) {
+            EXPECT_EQ(NULL, hash_map_get(&map, key));
+            hash_map_put(&map, key, (void *)&int_arr[i]);
+        }
+        EXPECT_EQ(int_arr[i], *(int *)hash_map_get(&map, key));
+    }
+    EXPECT_GT(hash_map_memory(&map), sizeof(HashMapSlot) * size);
+
+    hash_map_clear(&map);
+    EXPECT_EQ(0, map.size);
+    EXPECT_EQ(NULL, hash_map_get(&map, (char *)"key1"));
+
+    // borrowed keys are stored as they are
+    const char *key = "borrowed";
+    HashMap *borrowed = hash_map_create();
+    hash_map_borrow_keys(borrowed);
+    hash_map_open_addressing(borrowed);
+    hash_map_put(borrowed, key, (void *)&int_arr[0]);
+    int stored = 0;
+    for (size_t i = 0; i < borrowed->size; i++)
+        stored += borrowed->slots[i].key == key;
+    EXPECT_EQ(1, stored);
+    EXPECT_EQ(int_arr[0], *(int *)hash_map_get(borrowed, (char *)"borrowed"));
+    hash_map_free(borrowed);
+
+    hash_map_free(&map);
+}
+
+TEST(HashMapTest, OpenAddressingNonEmpty) {
+    const int size = 100;
+    int int_arr[size];
+    HashMap map;
+    hash_map_init(&map);
+    for (int i = 0; i < size; i++) {
+        char key[10];
+        int_arr[i] = i + 1;
+        sprintf(key, "key%d", i);
+        hash_map_put(&map, key, (void *)&int_arr[i]);
+    }
+
+    // the entries are moved into the slots in insertion order
+    hash_map_open_addressing(&map);
+    EXPECT_EQ(1, map.open_addressing);
+    EXPECT_EQ(size, map.size);
+    HashMapIterator iter;
+    hash_map_iter_begin(&map, &iter);
+    for (int i = 0; i < size; i++) {
+        char key[10];
+        sprintf(key, "key%d", i);
+        ASSERT_EQ(1, hash_map_iter_next(&iter));
+        EXPECT_STREQ(key, iter.key);
+        EXPECT_EQ(int_arr[i], *(int *)hash_map_get(&map, key));
+    }
+    EXPECT_EQ(0, hash_map_iter_next(&iter));
+
+    // the moved entries are removed and grown like inserted ones
+    hash_map_remove(&map, (char *)"key0");
+    EXPECT_EQ(NULL, hash_map_get(&map, (char *)"key0"));
+    hash_map_put(&map, (char *)"key100", (void *)&int_arr[0]);
+    EXPECT_EQ(int_arr[0], *(int *)hash_map_get(&map, (char *)"key100"));
+    EXPECT_EQ(size, map.size);
+
+    hash_map_free(&map);
+}
+
+TEST(HashMapTest, LongKeys) {
+    const int size = 200;
+    char keys[size][80];
+    for (int open = 0; open < 2; open++) {
+        HashMap map;
+        hash_map_init(&map);
+        if (open) hash_map_open_addressing(&map);
+        // keys differing only after a long common prefix
+        for (int i = 0; i < size; i++) {
+            sprintf(keys[i], "ch:1:sloid:8503000:0:route_IC5_Lausanne_%d", i);
+            hash_map_put(&map, keys[i], (void *)keys[i]);
+        }
+        for (int i = 0; i < size; i++)
+            EXPECT_EQ(keys[i], (char *)hash_map_get(&map, keys[i]));
+        EXPECT_EQ(NULL, hash_map_get(&map, (char *)"ch:1:sloid:8503000:0:"));
+        hash_map_free(&map);
+    }
+}
+
+TEST(HashMapTest, Reserve) {
+    const int size = 1000;
+    int int_arr[size];
+    for (int open = 0; open < 2; open++) {
+        HashMap *map = hash_map_create_with_capacity(size);
+        if (open) hash_map_open_addressing(map);
+        size_t capacity = map->capacity;
+        EXPECT_EQ((size_t)size, map->reserved);
+
+        // no resize while putting the reserved entries
+        for (int i = 0; i < size; i++) {
+            char key[10];
+            int_arr[i] = i;
+            sprintf(key, "key%d", i);
+            hash_map_put(map, key, (void *)&int_arr[i]);
+            EXPECT_EQ(capacity, map->capacity);
+        }
+
+        // nor when removing them again
+        for (int i = 0; i < size; i++) {
+            char key[10];
+            sprintf(key, "key%d", i);
+            hash_map_remove(map, key);
+        }
+        EXPECT_EQ(capacity, map->capacity);
+        hash_map_free(map);
+    }
+}
+
+TEST(HashMapTest, ShrinkHysteresis) {
+    const int size = 100;
+    int int_arr[size];
+    for (int open = 0; open < 2; open++) {
+        HashMap map;
+        hash_map_init(&map);
+        if (open) hash_map_open_addressing(&map);
+        for (int i = 0; i < size; i++) {
+            char key[10];
+            int_arr[i] = i;
+            sprintf(key, "key%d", i);
+            hash_map_put(&map, key, (void *)&int_arr[i]);
+        }
+
+        // a quarter of the entries do not shrink the table
+        size_t capacity = map.capacity;
+        for (int i = size / 4; i < size; i++) {
+            char key[10];
+            sprintf(key, "key%d", i);
+            hash_map_remove(&map, key);
+        }
+        EXPECT_EQ(capacity, map.capacity);
+
+        // an empty table keeps its initial capacity
+        for (int i = 0; i < size / 4; i++) {
+            char key[10];
+            sprintf(key, "key%d", i);
+            hash_map_remove(&map, key);
+        }
+        EXPECT_LT(map.capacity, capacity);
+        EXPECT_GT(map.capacity, 0);
+        hash_map_put(&map, (char *)"key0", (void *)&int_arr[0]);
+        EXPECT_EQ(int_arr[0], *(int *)hash_map_get(&map, (char *)"key0"));
+        hash_map_free(&map);
+    }
+}
+
+static void sum_values(const char *key, void *value, void *context) {
+    *(int *)context += *(int *)value;
+}
+
+TEST(HashMapTest, Iterate) {
+    int values[5] = {1, 2, 3, 4, 5};
+    for (int open = 0; open < 2; open++) {
+        HashMap map;
+        hash_map_init(&map);
+        if (open) hash_map_open_addressing(&map);
+
+        HashMapIterator iter;
+        hash_map_iter_begin(&map, &iter);
+        EXPECT_EQ(0, hash_map_iter_next(&iter));
+
+        const char *keys[5] = {"a", "b", "c", "d", "e"};
+        for (int i = 0; i < 5; i++)
+            hash_map_put(&map, keys[i], (void *)&values[i]);
+        hash_map_remove(&map, "b");
+
+        // every remaining entry is visited once, in insertion order until
+        // the last entry moved into the gap of the removed one
+        int seen = 0;
+        int count = 0;
+        hash_map_iter_begin(&map, &iter);
+        while (hash_map_iter_next(&iter)) {
+            EXPECT_EQ(iter.value, hash_map_get(&map, iter.key));
+            seen |= 1 << (*(int *)iter.value - 1);
+            ++count;
+        }
+        EXPECT_EQ(4, count);
+        EXPECT_EQ(0x1D, seen);
+        hash_map_iter_begin(&map, &iter);
+        hash_map_iter_next(&iter);
+        EXPECT_STREQ("a", iter.key);
+        hash_map_iter_next(&iter);
+        EXPECT_STREQ("e", iter.key);
+
+        int sum = 0;
+        hash_map_for_each(&map, sum_values, &sum);
+        EXPECT_EQ(1 + 3 + 4 + 5, sum);
+        hash_map_free(&map);
+    }
+}
+
 // LinkedList
 
 TEST(LinkedListTest, TestAddFirst) {
@@ -458,3 +754,51 @@ TEST(StackTest, PushPop) {
 
     stack_clear(&stack);
 }
+
+// StringPool
+
+TEST(StringPoolTest, Intern) {
+    StringPool *pool = string_pool_create();
+    char key[10];
+
+    strcpy(key, "8503000:0");
+    const char *s1 = string_pool_intern(pool, key);
+    strcpy(key, "8503000:1");
+    const char *s2 = string_pool_intern(pool, key);
+    strcpy(key, "8503000:0");
+    const char *s3 = string_pool_intern(pool, key);
+
+    EXPECT_STREQ("8503000:0", s1);
+    EXPECT_STREQ("8503000:1", s2);
+    EXPECT_EQ(s1, s3);
+    EXPECT_NE(s1, s2);
+    EXPECT_EQ(s2, string_pool_find(pool, "8503000:1"));
+    EXPECT_EQ(NULL, string_pool_find(pool, "8503000:2"));
+    EXPECT_EQ(2, pool->strings.size);
+
+    string_pool_free(pool);
+}
+
+TEST(StringPoolTest, Blocks) {
+    const int size = 1000;
+    const char *interned[size];
+    StringPool *pool = string_pool_create();
+    std::string large(10000, 'x');
+
+    for (int i = 0; i < size; i++) {
+        char key[20];
+        sprintf(key, "stop-%d", i);
+        interned[i] = string_pool_intern(pool, key);
+    }
+    const char *long_str = string_pool_intern(pool, large.c_str());
+
+    for (int i = 0; i < size; i++) {
+        char key[20];
+        sprintf(key, "stop-%d", i);
+        EXPECT_STREQ(key, interned[i]);
+        EXPECT_EQ(interned[i], string_pool_intern(pool, key));
+    }
+    EXPECT_EQ(large, long_str);
+
+    string_pool_free(pool);
+}
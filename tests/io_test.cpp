@@ -16,6 +16,12 @@ TEST(IOTest, Import) {
     EXPECT_EQ(success, 1);
     success = import_reservations(network, reservation_file);
     EXPECT_EQ(success, 1);
+
+    // The lookup maps are reserved with the counts of the root element
+    EXPECT_EQ(network->nodes->size, network->nodes->reserved);
+    EXPECT_EQ(network->routes->size, network->routes->reserved);
+    EXPECT_EQ(network->vehicles->size, network->vehicles->reserved);
+    EXPECT_EQ(network->compositions->size, network->compositions->reserved);
     delete_network(network);
 }
 
@@ -37,6 +43,46 @@ TEST(IOTest, Export) {
     EXPECT_EQ(success, 1);
     success = export_reservations(network, "tmp_reservation_export.xml");
     EXPECT_EQ(success, 1);
+    Calendar* calendar = new_calendar(network, "weekdays", 20000, 7);
+    for (int date = 20000; date < 20005; ++date)
+        calendar_set_day(calendar, date, 1);
+    Trip* trip = network_trip_at(network, 0);
+    trip->calendar = calendar;
+    Connection* connection =
+        new_connection_on(trip->route->root_stop->node,
+                          trip->route->root_stop->next->node, 0, 20003);
+    ASSERT_TRUE(connection != NULL);
+    EXPECT_TRUE(new_reservation(connection, 2, NULL) != NULL);
+    delete_connection(connection);
+    success = export_network(network, "tmp_calendar_export.xml");
+    EXPECT_EQ(success, 1);
+    success = export_reservations(network, "tmp_dated_export.xml");
+    EXPECT_EQ(success, 1);
+    NetworkSnapshot* snapshot = network_snapshot(network);
+    success = export_reservations_snapshot(snapshot,
+                                           "tmp_snapshot_export.xml");
+    EXPECT_EQ(success, 1);
+    delete_network(network);
+
+    // Calendars and dated reservations are imported again
+    network = new_network();
+    success = import_network(network, "tmp_calendar_export.xml");
+    EXPECT_EQ(success, 1);
+    calendar = get_calendar(network, "weekdays");
+    ASSERT_TRUE(calendar != NULL);
+    EXPECT_TRUE(calendar_has_day(calendar, 20004));
+    EXPECT_FALSE(calendar_has_day(calendar, 20005));
+    success = import_reservations(network, "tmp_dated_export.xml");
+    EXPECT_EQ(success, 1);
+    size_t days = 0;
+    for (size_t i = 0; i < network->trip_list->size; ++i) {
+        trip = network_trip_at(network, (int)i);
+        if (trip->calendar == NULL) continue;
+        EXPECT_EQ(trip->calendar, calendar);
+        days += trip->service_day_count;
+    }
+    EXPECT_EQ(days, (size_t)1);
+    EXPECT_EQ(network->service_day_list->size, (size_t)1);
     delete_network(network);
 
     // MATSim format import and export
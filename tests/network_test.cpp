@@ -118,8 +118,13 @@ TEST(NetworkTest, Create) {
               trip_size  // Trip properties
     );
     EXPECT_EQ(network->routes->size, 1);
+
+    // Stops know their position on the route
+    Stop *stop = get_route(network, route_id)->root_stop;
+    for (int i = 0; i < (int)route_size; ++i, stop = stop->next)
+        EXPECT_EQ(stop->ordinal, i);
     for (size_t i = 0; i < route_size; ++i) {
-        EXPECT_EQ(nodes[i]->routes->size, 1);
+        EXPECT_EQ(nodes[i]->route_count, 1);
     }
 
     // Reverse direction
@@ -145,7 +150,7 @@ TEST(NetworkTest, Create) {
     );
     EXPECT_EQ(network->routes->size, 2);
     for (size_t i = 0; i < route_size; ++i) {
-        EXPECT_EQ(nodes[i]->routes->size, 2);
+        EXPECT_EQ(nodes[i]->route_count, 2);
     }
 
     // Add routes for line IC 2
@@ -302,6 +307,39 @@ TEST(NetworkTest, Create) {
     );
     EXPECT_EQ(network->routes->size, 8);
 
+    // Identifiers are interned once and shared by the lookup maps
+    Route *route = get_route(network, "ic-1-we");
+    EXPECT_EQ(route->id, string_pool_find(network->ids, "ic-1-we"));
+    EXPECT_EQ(get_trip(route, "ic-1-we-2")->id,
+              string_pool_find(network->ids, "ic-1-we-2"));
+    EXPECT_EQ(ZUE->id, string_pool_intern(network->ids, "Zürich HB"));
+    EXPECT_TRUE(ZUE->routes[0] == route);
+
+    // Entities are numbered densely in the order of creation
+    EXPECT_EQ(BS->index, 0);
+    EXPECT_EQ(ZUE->index, 17);
+    EXPECT_EQ(network_node_at(network, ZUE->index), ZUE);
+    EXPECT_EQ(network_node_at(network, 18), (Node *)NULL);
+    EXPECT_EQ(network_vehicle_at(network, gir_2->index), gir_2);
+    EXPECT_EQ(route->index, 0);
+    EXPECT_EQ(network_route_at(network, route->index), route);
+    EXPECT_EQ(network->trip_list->size, 8 * 5);
+    for (Trip *trip = route->root_trip; trip != NULL; trip = trip->next) {
+        EXPECT_EQ(trip->index, route->root_trip->index + trip->ordinal);
+        EXPECT_EQ(network_trip_at(network, trip->index), trip);
+    }
+    EXPECT_EQ(network_trip_at(network, -1), (Trip *)NULL);
+
+    // Trips are found by identifier on every route
+    for (size_t r = 0; r < network->route_list->size; ++r) {
+        Route *curr_route = network_route_at(network, (int)r);
+        for (Trip *trip = curr_route->root_trip; trip != NULL;
+             trip = trip->next) {
+            EXPECT_EQ(get_trip(curr_route, trip->id), trip);
+        }
+    }
+    EXPECT_EQ(get_trip(route, "ic-1-we-0"), (Trip *)NULL);
+
     // Export test data
     // export_network(network, "intercity_network.xml");
 
@@ -1,6 +1,9 @@
+#include <climits>
+
 #include <gtest/gtest.h>
 
 extern "C" {
+#include <osurs/io.h>
 #include <osurs/olal.h>
 }
 
@@ -70,3 +73,335 @@ TEST(OlalTest, BasicTest) {
     delete_connection(c4);
     delete_network(network);
 }
+
+// Expect two seat collections to be equal
+static void expect_equal_collections(SeatCollection* a, SeatCollection* b) {
+    if (a == NULL || b == NULL) {
+        EXPECT_EQ(a, b);
+        return;
+    }
+    ASSERT_EQ(a->seat_count, b->seat_count);
+    for (int i = 0; i < a->seat_count; ++i) {
+        ASSERT_EQ(a->seat_arr[i]->res_count, b->seat_arr[i]->res_count);
+        for (int j = 0; j < a->seat_arr[i]->res_count; ++j) {
+            EXPECT_EQ(a->seat_arr[i]->res_id_arr[j],
+                      b->seat_arr[i]->res_id_arr[j]);
+        }
+    }
+}
+
+TEST(OlalTest, OptimizeNetwork) {
+    Network* network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        NetworkOptimization* result =
+            optimize_network(network, OPTIMIZE_COMPACT, threads);
+        EXPECT_EQ(result->size, 40);
+        EXPECT_LE(result->threads, threads);
+        int optimized = 0;
+        for (size_t i = 0; i < result->size; ++i) {
+            SeatCollection* expected =
+                optimize_trip_with(result->trips[i], OPTIMIZE_COMPACT);
+            expect_equal_collections(result->collections[i], expected);
+            if (expected != NULL) {
+                ++optimized;
+                delete_seat_collection(expected);
+            }
+        }
+        EXPECT_GT(optimized, 0);
+        delete_network_optimization(result);
+    }
+
+    // A single workspace gives the same results without reallocating
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+    NetworkOptimization* expected =
+        optimize_network(network, OPTIMIZE_GROUP_ADJACENT, 1);
+    for (int pass = 0; pass < 2; ++pass) {
+        unsigned long long* masks = workspace->masks;
+        SeatCollection* output = workspace->collection;
+        for (size_t i = 0; i < expected->size; ++i) {
+            expect_equal_collections(
+                optimize_trip_in(workspace, expected->trips[i],
+                                 OPTIMIZE_GROUP_ADJACENT),
+                expected->collections[i]);
+        }
+        if (pass > 0) {
+            EXPECT_EQ(workspace->masks, masks);
+            EXPECT_EQ(workspace->collection, output);
+        }
+    }
+    delete_network_optimization(expected);
+    delete_optimize_workspace(workspace);
+
+    // Only morning departures
+    NetworkOptimization* result = optimize_network_window(
+        network, 6 * HOURS, 9 * HOURS, OPTIMIZE_SPARSEST, 2);
+    EXPECT_EQ(result->size, 8);
+    for (size_t i = 0; i < result->size; ++i) {
+        EXPECT_GE(result->trips[i]->departure, 6 * HOURS);
+        EXPECT_LT(result->trips[i]->departure, 9 * HOURS);
+    }
+    delete_network_optimization(result);
+
+    delete_network(network);
+}
+
+TEST(OlalTest, ReoptimizeTrip) {
+    Network* network = new_network();
+    Node* n1 = new_node(network, "Albisrieden", 0.0, 0.0);
+    Node* n2 = new_node(network, "Buelach", 1.0, 0.0);
+    Node* n3 = new_node(network, "Chur", 1.0, 1.0);
+    Node* n4 = new_node(network, "Dietikon", 0.0, 1.0);
+    Composition* train = new_composition(network, "train", 4);
+    Vehicle* v1 = new_vehicle(network, "rt-1", train);
+    Node* nodes[] = {n1, n2, n3, n4};
+    int arrival_offsets[] = {0, 15 * MINUTES, 25 * MINUTES, 40 * MINUTES};
+    int departure_offsets[] = {0, 20 * MINUTES, 30 * MINUTES, 45 * MINUTES};
+    const char* trip_ids[] = {"blue-1"};
+    int departures[] = {6 * HOURS};
+    Vehicle* vehicles[] = {v1};
+    new_route(network, "blue", nodes, arrival_offsets, departure_offsets, 4,
+              trip_ids, departures, vehicles, 1);
+
+    Connection* c1 = new_connection(n1, n3, 6 * HOURS);
+    Connection* c2 = new_connection(n2, n4, 6 * HOURS);
+    Connection* c3 = new_connection(n3, n4, 6 * HOURS);
+    Connection* c4 = new_connection(n1, n2, 6 * HOURS);
+    Reservation* r1 = new_reservation(c1, 1, NULL);
+    Reservation* r2 = new_reservation(c2, 1, NULL);
+    Trip* trip = c1->trip;
+
+    SeatCollection* collection = optimize_trip_with(trip, OPTIMIZE_COMPACT);
+    ASSERT_NE(collection, nullptr);
+    EXPECT_EQ(collection->res_covered, 2);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[0], r1->res_id);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[0], r2->res_id);
+
+    // Nothing to do without new reservations
+    EXPECT_EQ(reoptimize_trip(trip, collection), collection);
+    EXPECT_EQ(collection->seat_arr[0]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[1]->res_count, 1);
+
+    // Late bookings are placed around the existing seats
+    Reservation* r3 = new_reservation(c3, 1, NULL);
+    Reservation* r4 = new_reservation(c4, 2, NULL);
+    EXPECT_EQ(reoptimize_trip(trip, collection), collection);
+    EXPECT_EQ(collection->res_covered, 4);
+    ASSERT_EQ(collection->seat_arr[0]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[0], r1->res_id);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[1], r3->res_id);
+    ASSERT_EQ(collection->seat_arr[1]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[0], r2->res_id);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[1], r4->res_id);
+    ASSERT_EQ(collection->seat_arr[2]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[2]->res_id_arr[0], r4->res_id);
+    EXPECT_EQ(collection->seat_arr[3]->res_count, 0);
+    EXPECT_EQ(collection->quality.unplaced, 0);
+    int count;
+    ASSERT_NE(seat_collection_find(collection, r4->res_id, &count), nullptr);
+    EXPECT_EQ(count, 2);
+
+    // Service days are reoptimized on their own reservations only
+    Calendar* calendar = new_calendar(network, "daily", 0, 10);
+    for (int date = 0; date < 10; ++date) calendar_set_day(calendar, date, 1);
+    trip->calendar = calendar;
+    Connection* d1 = new_connection_on(n1, n4, 6 * HOURS, 3);
+    ASSERT_NE(d1, nullptr);
+    Reservation* r5 = new_reservation(d1, 1, NULL);
+    ServiceDay* day = get_service_day(trip, 3);
+    ASSERT_NE(day, nullptr);
+    SeatCollection* day_collection =
+        optimize_service_day(day, OPTIMIZE_COMPACT);
+    ASSERT_NE(day_collection, nullptr);
+    EXPECT_EQ(reoptimize_trip(trip, day_collection), nullptr);
+    EXPECT_EQ(reoptimize_service_day(day, collection), nullptr);
+    Reservation* r6 = new_reservation(d1, 1, NULL);
+    EXPECT_EQ(reoptimize_service_day(day, day_collection), day_collection);
+    EXPECT_EQ(day_collection->res_covered, 2);
+    EXPECT_EQ(day_collection->seat_arr[0]->res_id_arr[0], r5->res_id);
+    EXPECT_EQ(day_collection->seat_arr[1]->res_id_arr[0], r6->res_id);
+    EXPECT_EQ(collection->res_covered, 4);
+
+    delete_seat_collection(day_collection);
+    delete_seat_collection(collection);
+    delete_connection(d1);
+    delete_connection(c1);
+    delete_connection(c2);
+    delete_connection(c3);
+    delete_connection(c4);
+    delete_network(network);
+}
+
+// Simulated time for the scheduler
+static int simulated_now(void* context) { return *(int*)context; }
+
+static void simulated_sleep(void* context, int seconds) {
+    *(int*)context += seconds;
+}
+
+typedef struct scheduled_t {
+    int count;
+    int last_departure;
+    int late;
+    int* now;
+} Scheduled;
+
+static void scheduled_trip(Trip* trip, SeatCollection* collection,
+                           void* context) {
+    Scheduled* scheduled = (Scheduled*)context;
+    ++scheduled->count;
+    if (trip->departure < scheduled->last_departure) ++scheduled->late;
+    if (trip->departure - 10 * MINUTES > *scheduled->now) ++scheduled->late;
+    scheduled->last_departure = trip->departure;
+    if (collection != NULL) delete_seat_collection(collection);
+}
+
+TEST(OlalTest, Scheduler) {
+    Network* network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+
+    int now = 0;
+    Scheduled scheduled = {0, 0, 0, &now};
+    Scheduler* scheduler =
+        new_scheduler(network, 10 * MINUTES, OPTIMIZE_COMPACT, 2);
+    scheduler_set_clock(scheduler, {simulated_now, simulated_sleep, &now});
+    scheduler_set_callback(scheduler, scheduled_trip, &scheduled);
+
+    // Nothing is due at midnight
+    EXPECT_EQ(scheduler_run_due(scheduler), 0);
+    EXPECT_EQ(scheduled.count, 0);
+
+    // The first trips are optimized 10 minutes before their departure
+    now = scheduler_next_due(scheduler);
+    size_t first = scheduler_run_due(scheduler);
+    EXPECT_GT(first, 0);
+    EXPECT_EQ(scheduled.count, (int)first);
+    EXPECT_GT(scheduler_next_due(scheduler), now);
+
+    // The simulated time runs until all trips are optimized
+    EXPECT_EQ(scheduler_run(scheduler) + first, 40);
+    EXPECT_EQ(scheduler->optimized, 40);
+    EXPECT_EQ(scheduled.count, 40);
+    EXPECT_EQ(scheduled.late, 0);
+    EXPECT_EQ(scheduler_next_due(scheduler), INT_MAX);
+    delete_scheduler(scheduler);
+
+    // Trips departing within the lead time are due at midnight
+    scheduler = new_scheduler(network, 24 * HOURS, OPTIMIZE_COMPACT, 2);
+    EXPECT_EQ(scheduler_next_due(scheduler), 0);
+    EXPECT_GE(scheduler->clock.now(scheduler->clock.context), 0);
+    delete_scheduler(scheduler);
+    delete_network(network);
+}
+
+TEST(OlalTest, OptimizeTripCached) {
+    Network* network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+    Node* orig = get_node(network, "Zürich HB");
+    Node* dest = get_node(network, "Bern");
+    Connection* connection = new_connection(orig, dest, 6 * HOURS);
+    ASSERT_NE(connection, nullptr);
+    Trip* trip = connection->trip;
+
+    // Repeated calls return the same collection
+    SeatCollection* cached = optimize_trip_cached(trip, OPTIMIZE_COMPACT);
+    EXPECT_EQ(optimize_trip_cached(trip, OPTIMIZE_COMPACT), cached);
+    EXPECT_EQ(trip->cache_version, trip->version);
+
+    // A new booking invalidates the cache
+    unsigned int version = trip->version;
+    ASSERT_NE(new_reservation(connection, 1, NULL), nullptr);
+    EXPECT_EQ(trip->version, version + 1);
+    SeatCollection* updated = optimize_trip_cached(trip, OPTIMIZE_COMPACT);
+    ASSERT_NE(updated, nullptr);
+    SeatCollection* expected = optimize_trip_with(trip, OPTIMIZE_COMPACT);
+    expect_equal_collections(updated, expected);
+    delete_seat_collection(expected);
+
+    // So does another strategy
+    expected = optimize_trip_with(trip, OPTIMIZE_SPARSEST);
+    expect_equal_collections(optimize_trip_cached(trip, OPTIMIZE_SPARSEST),
+                             expected);
+    delete_seat_collection(expected);
+
+    // Reoptimizing the cached collection keeps it cached
+    cached = optimize_trip_cached(trip, OPTIMIZE_SPARSEST);
+    ASSERT_NE(new_reservation(connection, 2, NULL), nullptr);
+    EXPECT_EQ(reoptimize_trip(trip, cached), cached);
+    EXPECT_EQ(trip->cache_version, trip->version);
+    EXPECT_EQ(optimize_trip_cached(trip, OPTIMIZE_SPARSEST), cached);
+    EXPECT_EQ(cached->res_covered, trip->reservations->size);
+
+    delete_connection(connection);
+    delete_network(network);
+}
+
+// Memory usage of a network with reservations and a cached result
+TEST(OlalTest, NetworkMemoryStats) {
+    Network* network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+
+    // A dated booking allocates a service day
+    Calendar* calendar = new_calendar(network, "daily", 0, 100);
+    for (int date = 0; date < 100; ++date)
+        calendar_set_day(calendar, date, 1);
+    Connection* connection = new_connection_on(
+        get_node(network, "Zürich HB"), get_node(network, "Lugano"), 0, 7);
+    ASSERT_NE(connection, nullptr);
+    connection->trip->calendar = calendar;
+    Reservation* dated = new_reservation(connection, 2, NULL);
+    ASSERT_NE(dated, nullptr);
+    delete_connection(connection);
+
+    NetworkMemoryStats stats = network_memory_stats(network);
+    EXPECT_EQ(stats.nodes.count, network->nodes->size);
+    EXPECT_EQ(stats.routes.count, network->routes->size);
+    EXPECT_EQ(stats.trips.count, network->trip_list->size);
+    EXPECT_EQ(stats.vehicles.count, network->vehicles->size);
+    EXPECT_EQ(stats.compositions.count, network->compositions->size);
+    EXPECT_EQ(stats.seat_collections.count, 0);
+    EXPECT_EQ(stats.calendars.count, 1);
+    EXPECT_EQ(stats.service_days.count, 1);
+    size_t reservations = 1;
+    for (size_t i = 0; i < network->trip_list->size; ++i)
+        reservations += network_trip_at(network, (int)i)->reservations->size;
+    EXPECT_GT(reservations, 0);
+    EXPECT_EQ(stats.reservations.count, reservations);
+
+    // The arena categories account for every byte handed out by the arena
+    EXPECT_EQ(stats.nodes.bytes + stats.routes.bytes + stats.stops.bytes +
+                  stats.occupancy.bytes + stats.trips.bytes +
+                  stats.calendars.bytes + stats.service_days.bytes +
+                  stats.vehicles.bytes + stats.compositions.bytes,
+              stats.arena_allocated);
+    EXPECT_GE(stats.arena_reserved, stats.arena_allocated);
+    EXPECT_GT(stats.ids.bytes, 0);
+    EXPECT_GT(stats.total, stats.arena_reserved);
+
+    // Cached results are included
+    Trip* trip = network_trip_at(network, 0);
+    for (int i = 0; trip->reservations->size == 0; ++i)
+        trip = network_trip_at(network, i);
+    SeatCollection* cached = optimize_trip_cached(trip, OPTIMIZE_COMPACT);
+    ASSERT_NE(cached, nullptr);
+    NetworkMemoryStats cached_stats = network_memory_stats(network);
+    EXPECT_EQ(cached_stats.seat_collections.count, 1);
+    EXPECT_EQ(cached_stats.seat_collections.bytes,
+              seat_collection_memory(cached));
+    EXPECT_EQ(cached_stats.total,
+              stats.total + seat_collection_memory(cached));
+
+    // Service days are optimized on their own reservations
+    SeatCollection* day_collection = optimize_service_day(
+        get_service_day(dated->trip, 7), OPTIMIZE_COMPACT);
+    ASSERT_NE(day_collection, nullptr);
+    EXPECT_EQ(day_collection->res_covered, 1);
+    delete_seat_collection(day_collection);
+
+    delete_network(network);
+}
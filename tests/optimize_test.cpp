@@ -41,4 +41,244 @@ TEST(OptimizeTest, OptimizeReservation) {
     EXPECT_EQ(result_collection->seat_arr[1]->res_id_arr[1], 30);
 
     delete_seat_collection(result_collection);
-}
\ No newline at end of file
+}
+
+TEST(OptimizeTest, StrategyRegistry) {
+    for (int i = 0; i < OPTIMIZE_STRATEGY_COUNT; ++i) {
+        const OptimizeStrategyInfo* info =
+            get_optimize_strategy((OptimizeStrategy)i);
+        ASSERT_TRUE(info != NULL);
+        EXPECT_EQ(info->strategy, i);
+        EXPECT_EQ(get_optimize_strategy_by_name(info->name), info);
+    }
+    EXPECT_TRUE(get_optimize_strategy(OPTIMIZE_STRATEGY_COUNT) == NULL);
+    EXPECT_TRUE(get_optimize_strategy_by_name("unknown") == NULL);
+}
+
+TEST(OptimizeTest, CompactStrategy) {
+    int res_ids[] = {10, 20, 30, 40};
+    unsigned int res_arr[] = {1, 3, 4, 6};
+    unsigned int res_arr2[] = {1, 3, 4, 6};
+    int seat_ids[] = {100, 200};
+
+    // The sparsest strategy places in booking order and misses reservation 40
+    SeatCollection* sparsest =
+        optimize_reservation(res_arr, 4, res_ids, 3, seat_ids, 2);
+    EXPECT_EQ(res_arr[3], 6u);
+    delete_seat_collection(sparsest);
+
+    // Ordered by origin all reservations fit
+    SeatCollection* collection = optimize_reservation_with(
+        OPTIMIZE_COMPACT, res_arr2, 4, res_ids, 3, seat_ids, 2);
+    ASSERT_EQ(collection->seat_arr[0]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[0], 10);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[1], 40);
+    ASSERT_EQ(collection->seat_arr[1]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[0], 20);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[1], 30);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(res_arr2[i], 0u);
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, GroupAdjacentStrategy) {
+    // A single seat reservation followed by a group of two
+    int res_ids[] = {10, 20, 20};
+    unsigned int res_arr[] = {1, 3, 3};
+    int seat_ids[] = {100, 200, 300};
+
+    SeatCollection* collection = optimize_reservation_with(
+        OPTIMIZE_GROUP_ADJACENT, res_arr, 3, res_ids, 2, seat_ids, 3);
+
+    EXPECT_EQ(collection->seat_arr[0]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[1]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[2]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[0], 20);
+    EXPECT_EQ(collection->seat_arr[2]->res_id_arr[0], 20);
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, WideStrategy) {
+    int res_ids[] = {10, 20, 30};
+    unsigned long long res_arr[] = {1ull << 40, (1ull << 40) | 1ull,
+                                    1ull << 63};
+    int seat_ids[] = {100, 200};
+
+    SeatCollection* collection = optimize_reservation_wide(
+        OPTIMIZE_SPARSEST, res_arr, 3, res_ids, 64, seat_ids, 2);
+
+    EXPECT_EQ(collection->seat_arr[0]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[0], 10);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[1], 30);
+    EXPECT_EQ(collection->seat_arr[1]->res_count, 1);
+    EXPECT_EQ(collection->seat_arr[1]->res_id_arr[0], 20);
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, Workspace) {
+    int res_ids[] = {10, 20, 30, 40};
+    unsigned long long res_arr[] = {1, 3, 4, 6};
+    int seat_ids[] = {100, 200};
+    OptimizeWorkspace* workspace = new_optimize_workspace();
+
+    SeatCollection* collection = optimize_reservation_in(
+        workspace, OPTIMIZE_COMPACT, res_arr, 4, res_ids, 3, seat_ids, 2);
+    ASSERT_EQ(collection->seat_arr[0]->res_count, 2);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[0], 10);
+    EXPECT_EQ(collection->seat_arr[0]->res_id_arr[1], 40);
+    for (int j = 0; j < 4; ++j) EXPECT_EQ(res_arr[j], 0);
+
+    // The second call reuses the buffers and the output collection
+    unsigned long long* masks = workspace->masks;
+    unsigned long long res_arr_2[] = {1ull << 40, 1ull << 41};
+    SeatCollection* reused = optimize_reservation_in(
+        workspace, OPTIMIZE_SPARSEST, res_arr_2, 2, res_ids, 42, seat_ids, 1);
+    EXPECT_EQ(reused, collection);
+    EXPECT_EQ(workspace->masks, masks);
+    EXPECT_EQ(reused->seat_count, 1);
+    ASSERT_EQ(reused->seat_arr[0]->res_count, 2);
+    EXPECT_EQ(reused->seat_arr[0]->res_id_arr[1], 20);
+
+    // A detached collection belongs to the caller
+    SeatCollection* detached = optimize_workspace_detach(workspace);
+    EXPECT_EQ(detached, collection);
+    EXPECT_EQ(optimize_workspace_detach(workspace), nullptr);
+    delete_seat_collection(detached);
+    delete_optimize_workspace(workspace);
+}
+
+TEST(OptimizeTest, ManyReservationsPerSeat) {
+    const int count = 20;
+    int res_ids[count];
+    unsigned int res_arr[count];
+    int seat_ids[] = {100};
+    for (int i = 0; i < count; ++i) {
+        res_ids[i] = i;
+        res_arr[i] = 1u << i;
+    }
+
+    SeatCollection* collection =
+        optimize_reservation(res_arr, count, res_ids, count, seat_ids, 1);
+
+    ASSERT_EQ(collection->seat_arr[0]->res_count, count);
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(collection->seat_arr[0]->res_id_arr[i], i);
+    }
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, SeatIndex) {
+    int res_ids[] = {0, 10, 10, 20};
+    unsigned int res_arr[] = {1, 3, 3, 4};
+    int seat_ids[] = {100, 200, 300};
+
+    SeatCollection* collection = optimize_reservation_with(
+        OPTIMIZE_COMPACT, res_arr, 4, res_ids, 3, seat_ids, 3);
+    EXPECT_NE(collection->index, nullptr);
+
+    int count;
+    const int* seats = seat_collection_find(collection, 10, &count);
+    ASSERT_EQ(count, 2);
+    EXPECT_EQ(seats[0], 200);
+    EXPECT_EQ(seats[1], 300);
+    seats = seat_collection_find(collection, 0, &count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(seats[0], 100);
+    seats = seat_collection_find(collection, 20, &count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(seats[0], 100);
+    EXPECT_EQ(seat_collection_find(collection, 30, &count), nullptr);
+    EXPECT_EQ(count, 0);
+
+    // A modified collection is indexed again
+    seat_add_reservation(collection->seat_arr[2], 30);
+    seat_collection_build_index(collection);
+    seats = seat_collection_find(collection, 30, &count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(seats[0], 300);
+
+    // Without an index nothing is found and nothing is allocated
+    seat_collection_clear_index(collection);
+    EXPECT_EQ(seat_collection_find(collection, 30, &count), nullptr);
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(collection->index, nullptr);
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, FindFreeSeats) {
+    const int seat_count = 200;
+    const int res_count = 150;
+    int seat_ids[seat_count];
+    int res_ids[res_count];
+    unsigned int res_arr[res_count];
+    for (int i = 0; i < seat_count; ++i) seat_ids[i] = 1000 + i;
+    for (int j = 0; j < res_count; ++j) {
+        res_ids[j] = j;
+        res_arr[j] = j < 20 ? 0x3 : 0x8;
+    }
+
+    // Seats 0-19 are reserved on segments 0, 1 and 3, seats 20-129 on
+    // segment 3 and seats 130-199 are free
+    SeatCollection* collection = optimize_reservation_with(
+        OPTIMIZE_SPARSEST, res_arr, res_count, res_ids, 4, seat_ids,
+        seat_count);
+    int out[seat_count];
+
+    // From stop 0 to stop 2 (segments 0 and 1)
+    int count = find_free_seats(collection, 0, 2, out, seat_count);
+    ASSERT_EQ(count, 180);
+    for (int k = 0; k < count; ++k) EXPECT_EQ(out[k], 1020 + k);
+
+    // From stop 1 to stop 4 (segments 1 to 3)
+    count = find_free_seats(collection, 1, 4, out, seat_count);
+    ASSERT_EQ(count, 70);
+    EXPECT_EQ(out[0], 1130);
+
+    // Limited output and invalid ranges
+    EXPECT_EQ(find_free_seats(collection, 0, 2, out, 5), 5);
+    EXPECT_EQ(find_free_seats(collection, 2, 2, out, seat_count), 0);
+    EXPECT_EQ(find_free_seats(collection, 0, 65, out, seat_count), 0);
+
+    delete_seat_collection(collection);
+}
+
+TEST(OptimizeTest, AnytimeSolver) {
+    // The greedy solution seats group 10 on the non-adjacent seats 0 and 2
+    int res_ids[] = {10, 10, 20, 30, 40};
+    unsigned long long res_arr[] = {4, 4, 3, 7, 2};
+    int seat_ids[] = {100, 200, 300};
+
+    SeatCollection* greedy = optimize_reservation_anytime(
+        res_arr, 5, res_ids, 3, seat_ids, 3, 0);
+    EXPECT_EQ(greedy->quality.groups_split, 1);
+    EXPECT_EQ(greedy->quality.iterations, 0);
+    EXPECT_EQ(greedy->quality.unplaced, 0);
+    delete_seat_collection(greedy);
+
+    SeatCollection* collection = optimize_reservation_anytime(
+        res_arr, 5, res_ids, 3, seat_ids, 3, 1000000);
+    EXPECT_EQ(collection->quality.deadline_us, 1000000);
+    EXPECT_EQ(collection->quality.groups_split, 0);
+    EXPECT_EQ(collection->quality.unplaced, 0);
+    EXPECT_EQ(collection->quality.seat_changes, 0);
+    EXPECT_GT(collection->quality.iterations, 0);
+    EXPECT_LT(collection->quality.elapsed_us, 1000000);
+
+    // Group 10 is seated side by side
+    int group_seats[2];
+    int count = 0;
+    for (int i = 0; i < collection->seat_count; ++i) {
+        Seat* seat = collection->seat_arr[i];
+        for (int j = 0; j < seat->res_count; ++j) {
+            if (seat->res_id_arr[j] == 10) group_seats[count++] = i;
+        }
+    }
+    ASSERT_EQ(count, 2);
+    EXPECT_EQ(abs(group_seats[0] - group_seats[1]), 1);
+
+    delete_seat_collection(collection);
+}
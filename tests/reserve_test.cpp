@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
 extern "C" {
 #include <limits.h>
 #include <osurs/io.h>
@@ -95,4 +101,374 @@ TEST(ReserveTest, NewReservation) {
     delete_connection(con1);
     delete_connection(con2);
     delete_network(network);
-}
\ No newline at end of file
+}
+// Search connections on a frozen network
+TEST(ReserveTest, FrozenConnection) {
+    // Load test network
+    Network *network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    FrozenNetwork *frozen = freeze_network(network);
+    EXPECT_EQ(frozen->node_count, (int)network->nodes->size);
+    EXPECT_TRUE(frozen_new_connection_at(frozen, -1, 0, 0) == NULL);
+    EXPECT_EQ(frozen->route_count, (int)network->routes->size);
+
+    // Book on a frozen connection, the view is updated with the network
+    Node *orig = get_node(network, "Zürich HB");
+    Node *dest = get_node(network, "Lugano");
+    Connection *con = frozen_new_connection(frozen, orig, dest, 60 * 60 * 12);
+    ASSERT_TRUE(con != NULL);
+    EXPECT_TRUE(new_reservation(con, 3, NULL) != NULL);
+    delete_connection(con);
+
+    // Compare all connections with the search on the network
+    for (int i = 0; i < frozen->node_count; ++i) {
+        for (int j = 0; j < frozen->node_count; ++j) {
+            for (int time = 0; time < 60 * 60 * 24; time += 60 * 60 * 5) {
+                Node *a = frozen->nodes[i];
+                Node *b = frozen->nodes[j];
+                Connection *expected = new_connection(a, b, time);
+                Connection *actual = frozen_new_connection(frozen, a, b, time);
+                Connection *e = expected;
+                Connection *f = actual;
+                while (e != NULL && f != NULL) {
+                    EXPECT_EQ(e->trip, f->trip);
+                    EXPECT_EQ(e->orig, f->orig);
+                    EXPECT_EQ(e->dest, f->dest);
+                    EXPECT_EQ(e->departure, f->departure);
+                    EXPECT_EQ(e->arrival, f->arrival);
+                    EXPECT_EQ(e->available, f->available);
+                    e = e->next;
+                    f = f->next;
+                }
+                EXPECT_TRUE(e == NULL && f == NULL);
+                delete_connection(expected);
+                delete_connection(actual);
+
+                // Index variants find the same connections
+                Connection *indexed = new_connection_at(network, i, j, time);
+                Connection *frozen_indexed =
+                    frozen_new_connection_at(frozen, i, j, time);
+                EXPECT_EQ(indexed == NULL, frozen_indexed == NULL);
+                if (indexed != NULL && frozen_indexed != NULL) {
+                    EXPECT_EQ(indexed->trip, frozen_indexed->trip);
+                }
+                delete_connection(indexed);
+                delete_connection(frozen_indexed);
+            }
+        }
+    }
+
+    // Cleanup
+    delete_frozen_network(frozen);
+    delete_network(network);
+}
+
+// Read consistent reservations from snapshots while booking
+TEST(ReserveTest, Snapshot) {
+    // Load test network
+    Network *network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    FrozenNetwork *frozen = freeze_network(network);
+    Node *orig = get_node(network, "Zürich HB");
+    Node *dest = get_node(network, "Lugano");
+    Connection *con = new_connection(orig, dest, 60 * 60 * 12);
+    ASSERT_TRUE(con != NULL);
+    Trip *trip = con->trip;
+    Stop *stop = con->orig;
+    EXPECT_TRUE(new_reservation(con, 2, NULL) != NULL);
+
+    // Bookings after the snapshot are not visible to it
+    NetworkSnapshot *first = network_snapshot(network);
+    int *shared = stop->reserved;
+    EXPECT_TRUE(new_reservation(con, 3, NULL) != NULL);
+    EXPECT_NE(stop->reserved, shared);
+    EXPECT_EQ(stop->reserved[trip->ordinal], 5);
+    EXPECT_EQ(snapshot_reserved(first, stop, trip), 2);
+    EXPECT_EQ(snapshot_reservation_count(first, trip), (size_t)1);
+    EXPECT_TRUE(snapshot_reservation(first, trip, 1) == NULL);
+    NetworkMemoryStats stats = network_memory_stats(network);
+    EXPECT_EQ(stats.snapshots.count, (size_t)1);
+
+    // Only the first write after a snapshot copies the array
+    int *copy = stop->reserved;
+    NetworkSnapshot *second = network_snapshot(network);
+    EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+    EXPECT_NE(stop->reserved, copy);
+    copy = stop->reserved;
+    EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+    EXPECT_EQ(stop->reserved, copy);
+    EXPECT_EQ(snapshot_reserved(first, stop, trip), 2);
+    EXPECT_EQ(snapshot_reserved(second, stop, trip), 5);
+    EXPECT_EQ(snapshot_reservation_count(second, trip), (size_t)2);
+    EXPECT_EQ(stop->reserved[trip->ordinal], 7);
+
+    // The frozen view sees the bookings made after freezing
+    Connection *frozen_con = frozen_new_connection(frozen, orig, dest,
+                                                   60 * 60 * 12);
+    ASSERT_TRUE(frozen_con != NULL);
+    EXPECT_EQ(frozen_con->trip, trip);
+    EXPECT_EQ(frozen_con->available,
+              trip->vehicle->composition->seat_count - 7);
+    int trip_count;
+    EXPECT_EQ(check_connection(frozen_con, INT_MAX / 2, &trip_count),
+              check_connection(con, INT_MAX / 2, &trip_count));
+    delete_connection(frozen_con);
+
+    // A full reservation list shared with a snapshot is copied, not moved
+    void **elements = trip->reservations->elements;
+    while (trip->reservations->size < trip->reservations->capacity)
+        EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+    EXPECT_EQ(trip->reservations->elements, elements);
+    EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+    EXPECT_NE(trip->reservations->elements, elements);
+    EXPECT_EQ(snapshot_reservation_count(second, trip), (size_t)2);
+    EXPECT_EQ(snapshot_reservation(second, trip, 1),
+              (Reservation *)elements[1]);
+
+    // Deleting the snapshots releases the shared arrays
+    delete_network_snapshot(first);
+    EXPECT_EQ(snapshot_reserved(second, stop, trip), 5);
+    delete_network_snapshot(second);
+    EXPECT_EQ(network->retired->size, (size_t)0);
+
+    // Live snapshots are released with the network
+    network_snapshot(network);
+    EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+
+    // Cleanup
+    delete_connection(con);
+    delete_frozen_network(frozen);
+    delete_network(network);
+}
+
+static std::string read_file(const char *filename) {
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// Export from a snapshot in one thread while another thread books
+TEST(ReserveTest, SnapshotConcurrentBooking) {
+    // Load test network, the trips of the first route run daily
+    Network *network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+    Calendar *daily = new_calendar(network, "daily", 0, 30);
+    for (int date = 0; date < 30; ++date) calendar_set_day(daily, date, 1);
+    Node *orig = get_node(network, "Zürich HB");
+    Node *dest = get_node(network, "Lugano");
+    Connection *con = new_connection_on(orig, dest, 60 * 60 * 6, 0);
+    ASSERT_TRUE(con != NULL);
+    for (Trip *curr = con->trip->route->root_trip; curr != NULL;
+         curr = curr->next)
+        curr->calendar = daily;
+    EXPECT_TRUE(new_reservation(con, 2, NULL) != NULL);
+    delete_connection(con);
+
+    NetworkSnapshot *snapshot = network_snapshot(network);
+    ASSERT_EQ(export_reservations_snapshot(snapshot, "tmp_snapshot_before.xml"),
+              1);
+    std::string before = read_file("tmp_snapshot_before.xml");
+
+    // Book undated and dated connections, which grows the reservation lists
+    // and allocates service days
+    std::atomic<bool> done(false);
+    int booked = 0;
+    std::thread booking([&]() {
+        for (int date = 0; date < 30; ++date) {
+            for (int hour = 6; hour < 20; ++hour) {
+                Connection *undated = new_connection(orig, dest, hour * 3600);
+                if (new_reservation(undated, 1, NULL) != NULL) ++booked;
+                delete_connection(undated);
+                Connection *dated =
+                    new_connection_on(orig, dest, hour * 3600, date);
+                if (new_reservation(dated, 1, NULL) != NULL) ++booked;
+                delete_connection(dated);
+            }
+        }
+        done = true;
+    });
+
+    // The snapshot exports the same reservations while bookings continue
+    int exports = 0;
+    do {
+        ASSERT_EQ(
+            export_reservations_snapshot(snapshot, "tmp_snapshot_during.xml"),
+            1);
+        EXPECT_EQ(read_file("tmp_snapshot_during.xml"), before);
+        delete_network_snapshot(network_snapshot(network));
+        ++exports;
+    } while (!done);
+    booking.join();
+    EXPECT_GT(exports, 0);
+    EXPECT_GT(booked, 0);
+    EXPECT_EQ(read_file("tmp_snapshot_during.xml"), before);
+
+    // A new snapshot sees the bookings
+    delete_network_snapshot(snapshot);
+    ASSERT_EQ(export_reservations(network, "tmp_snapshot_after.xml"), 1);
+    EXPECT_NE(read_file("tmp_snapshot_after.xml"), before);
+
+    // Cleanup
+    delete_network(network);
+}
+
+// Book the same trip on several service dates
+TEST(ReserveTest, ServiceDays) {
+    // Load test network, the trips of the first route run on weekdays
+    Network *network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    Calendar *weekdays = new_calendar(network, "weekdays", 100, 14);
+    for (int date = 100; date < 114; ++date)
+        calendar_set_day(weekdays, date, (date - 100) % 7 < 5);
+    EXPECT_TRUE(calendar_has_day(weekdays, 104));
+    EXPECT_FALSE(calendar_has_day(weekdays, 105));
+    EXPECT_FALSE(calendar_has_day(weekdays, 99));
+    EXPECT_FALSE(calendar_has_day(weekdays, 114));
+    EXPECT_EQ(get_calendar(network, "weekdays"), weekdays);
+
+    Node *orig = get_node(network, "Zürich HB");
+    Node *dest = get_node(network, "Lugano");
+    Connection *con = new_connection_on(orig, dest, 60 * 60 * 12, 100);
+    ASSERT_TRUE(con != NULL);
+    Trip *trip = con->trip;
+    Stop *stop = con->orig;
+    for (Trip *curr = trip->route->root_trip; curr != NULL; curr = curr->next)
+        curr->calendar = weekdays;
+    EXPECT_TRUE(trip_runs_on(trip, 100));
+    EXPECT_FALSE(trip_runs_on(trip, 105));
+    EXPECT_EQ(con->date, 100);
+
+    // Service days are allocated on the first booking of the date
+    EXPECT_TRUE(get_service_day(trip, 100) == NULL);
+    EXPECT_TRUE(new_reservation(con, 3, NULL) != NULL);
+    ServiceDay *day = get_service_day(trip, 100);
+    ASSERT_TRUE(day != NULL);
+    EXPECT_EQ(day->trip, trip);
+    EXPECT_EQ(day->reserved[stop->ordinal], 3);
+    EXPECT_EQ(day->reservations->size, (size_t)1);
+    EXPECT_EQ(trip->reservations->size, (size_t)0);
+    EXPECT_EQ(stop->reserved[trip->ordinal], 0);
+    EXPECT_EQ(network->service_day_list->size, (size_t)1);
+
+    // Dates are booked independently, days are kept sorted by date
+    Connection *later = new_connection_on(orig, dest, 60 * 60 * 12, 108);
+    ASSERT_TRUE(later != NULL);
+    Connection *first = new_connection_on(orig, dest, 60 * 60 * 12, 101);
+    ASSERT_TRUE(first != NULL);
+    int capacity = trip->vehicle->composition->seat_count;
+    EXPECT_EQ(later->available, capacity);
+    EXPECT_TRUE(new_reservation(later, capacity, NULL) != NULL);
+    EXPECT_TRUE(new_reservation(first, 1, NULL) != NULL);
+    EXPECT_TRUE(new_reservation(later, 1, NULL) == NULL);
+    EXPECT_TRUE(new_reservation(con, 1, NULL) != NULL);
+    EXPECT_EQ(trip->service_day_count, 3);
+    EXPECT_EQ(trip->service_days[0]->date, 100);
+    EXPECT_EQ(trip->service_days[1]->date, 101);
+    EXPECT_EQ(trip->service_days[2]->date, 108);
+
+    // No connections on dates the trips do not run
+    Connection *weekend = new_connection_on(orig, dest, 0, 105);
+    for (Connection *c = weekend; c != NULL; c = c->next)
+        EXPECT_NE(c->trip->route, trip->route);
+    EXPECT_TRUE(new_service_day(trip, 105) == NULL);
+
+    // Snapshots include the service days
+    NetworkSnapshot *snapshot = network_snapshot(network);
+    EXPECT_TRUE(new_reservation(con, 2, NULL) != NULL);
+    EXPECT_EQ(snapshot_service_day_reserved(snapshot, day, stop), 4);
+    EXPECT_EQ(snapshot_service_day_reservation_count(snapshot, day),
+              (size_t)2);
+    EXPECT_EQ(day->reserved[stop->ordinal], 6);
+    delete_network_snapshot(snapshot);
+
+    // Cleanup
+    delete_connection(weekend);
+    delete_connection(first);
+    delete_connection(later);
+    delete_connection(con);
+    delete_network(network);
+}
+
+// Partition a network by route into independent shards
+TEST(ReserveTest, Shards) {
+    // Load test network
+    Network *network = new_network();
+    import_network(network, "input/intercity_network.xml");
+    import_reservations(network, "input/intercity_reservations.xml");
+    EXPECT_TRUE(shard_network(network, 0, NULL) == NULL);
+    NetworkShards *shards = shard_network(network, 3, NULL);
+    ASSERT_TRUE(shards != NULL);
+
+    // Every route is copied with its reservations into its shard
+    size_t routes = 0;
+    for (int s = 0; s < shards->shard_count; ++s)
+        routes += shards->shards[s]->routes->size;
+    EXPECT_EQ(routes, network->routes->size);
+    for (size_t r = 0; r < network->route_list->size; ++r) {
+        Route *route = network_route_at(network, (int)r);
+        Network *shard = shards->shards[shards->route_shards[r]];
+        Route *copy = (Route *)hash_map_get(shard->routes, route->id);
+        ASSERT_TRUE(copy != NULL);
+        Trip *trip = route->root_trip;
+        for (Trip *curr = copy->root_trip; curr != NULL; curr = curr->next) {
+            EXPECT_STREQ(curr->id, trip->id);
+            EXPECT_EQ(curr->reservations->size, trip->reservations->size);
+            trip = trip->next;
+        }
+    }
+
+    // Connections are found on the shards serving both nodes
+    for (int i = 0; i < (int)network->node_list->size; ++i) {
+        for (int j = 0; j < (int)network->node_list->size; ++j) {
+            Node *orig = network_node_at(network, i);
+            Node *dest = network_node_at(network, j);
+            Connection *expected = new_connection(orig, dest, 60 * 60 * 8);
+            int serving[3];
+            int count = shards_serving(shards, orig, dest, serving);
+            int found = 0;
+            long found_available = 0;
+            for (int k = 0; k < count; ++k) {
+                Network *shard = shards->shards[serving[k]];
+                Connection *actual = new_connection(
+                    get_node(shard, orig->id), get_node(shard, dest->id),
+                    60 * 60 * 8);
+                for (Connection *c = actual; c != NULL; c = c->next) {
+                    ++found;
+                    found_available += c->available;
+                }
+                delete_connection(actual);
+            }
+            int total = 0;
+            long total_available = 0;
+            for (Connection *c = expected; c != NULL; c = c->next) {
+                ++total;
+                total_available += c->available;
+            }
+            EXPECT_EQ(found, total);
+            EXPECT_EQ(found_available, total_available);
+            delete_connection(expected);
+        }
+    }
+
+    // Shards with a given assignment are exported and imported on their own
+    int *assignment = (int *)calloc(network->route_list->size, sizeof(int));
+    assignment[0] = 1;
+    EXPECT_TRUE(shard_network(network, 1, assignment) == NULL);
+    NetworkShards *pinned = shard_network(network, 2, assignment);
+    ASSERT_TRUE(pinned != NULL);
+    EXPECT_EQ(pinned->shards[1]->routes->size, (size_t)1);
+    EXPECT_EQ(export_network(pinned->shards[1], "tmp_shard_export.xml"), 1);
+    Network *imported = new_network();
+    EXPECT_EQ(import_network(imported, "tmp_shard_export.xml"), 1);
+    EXPECT_EQ(imported->routes->size, (size_t)1);
+    EXPECT_EQ(imported->nodes->size, pinned->shards[1]->nodes->size);
+
+    // Cleanup
+    delete_network(imported);
+    delete_network_shards(pinned);
+    free(assignment);
+    delete_network_shards(shards);
+    delete_network(network);
+}